@@ -0,0 +1,40 @@
+#include "bandplan.h"
+
+#include <cmath>
+
+namespace {
+
+const char *const kBandNames[kBandCount + 1] = {
+    "", "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2"
+};
+
+}
+
+QString bandName(Band band)
+{
+    return QString::fromLatin1(kBandNames[int(band)]);
+}
+
+Band bandForName(QStringView name)
+{
+    QStringView trimmed = name.trimmed();
+    if (trimmed.endsWith(QLatin1Char('m'), Qt::CaseInsensitive)) {
+        trimmed.chop(1);
+    }
+    for (int i = 1; i <= kBandCount; ++i) {
+        if (trimmed == QLatin1String(kBandNames[i])) {
+            return Band(i);
+        }
+    }
+    return Band::None;
+}
+
+qint64 frequencyHz(QStringView text)
+{
+    bool ok = false;
+    const double value = text.trimmed().toDouble(&ok);
+    if (!ok || !(value > 0.0)) {
+        return 0;
+    }
+    return std::llround(value > 1000.0 ? value * 1e3 : value * 1e6);
+}
@@ -0,0 +1,158 @@
+#ifndef BANDPLAN_H
+#define BANDPLAN_H
+
+#include <QString>
+#include <QStringView>
+
+// The one HF/VHF band plan, in integer Hz. Every band the logbook tracks is
+// split into CW, digital and phone segments; a frequency maps to its band
+// and segment with a binary search over kSegments, at compile time when the
+// frequency is a constant.
+
+enum class Band : quint8 {
+    None,
+    M160, M80, M40, M30, M20, M17, M15, M12, M10, M6, M2,
+};
+
+enum class Segment : quint8 {
+    None,
+    Cw,
+    Digital,
+    Phone,
+};
+
+struct BandSegment {
+    qint64 startHz;     // segment runs up to the next entry's startHz
+    Band band;
+    Segment segment;
+};
+
+// Sorted by start; Band::None entries close each band. The split is a
+// compromise between IARU regions, placing the common FT8/FT4 dial
+// frequencies in the digital segments.
+inline constexpr BandSegment kSegments[] = {
+    {0, Band::None, Segment::None},
+    {1800000, Band::M160, Segment::Cw},
+    {1838000, Band::M160, Segment::Digital},
+    {1843000, Band::M160, Segment::Phone},
+    {2000000, Band::None, Segment::None},
+    {3500000, Band::M80, Segment::Cw},
+    {3570000, Band::M80, Segment::Digital},
+    {3600000, Band::M80, Segment::Phone},
+    {4000000, Band::None, Segment::None},
+    {7000000, Band::M40, Segment::Cw},
+    {7040000, Band::M40, Segment::Digital},
+    {7080000, Band::M40, Segment::Phone},
+    {7300000, Band::None, Segment::None},
+    {10100000, Band::M30, Segment::Cw},
+    {10130000, Band::M30, Segment::Digital},
+    {10150000, Band::None, Segment::None},
+    {14000000, Band::M20, Segment::Cw},
+    {14070000, Band::M20, Segment::Digital},
+    {14100000, Band::M20, Segment::Phone},
+    {14350000, Band::None, Segment::None},
+    {18068000, Band::M17, Segment::Cw},
+    {18095000, Band::M17, Segment::Digital},
+    {18110000, Band::M17, Segment::Phone},
+    {18168000, Band::None, Segment::None},
+    {21000000, Band::M15, Segment::Cw},
+    {21070000, Band::M15, Segment::Digital},
+    {21150000, Band::M15, Segment::Phone},
+    {21450000, Band::None, Segment::None},
+    {24890000, Band::M12, Segment::Cw},
+    {24915000, Band::M12, Segment::Digital},
+    {24930000, Band::M12, Segment::Phone},
+    {24990000, Band::None, Segment::None},
+    {28000000, Band::M10, Segment::Cw},
+    {28070000, Band::M10, Segment::Digital},
+    {28300000, Band::M10, Segment::Phone},
+    {29700000, Band::None, Segment::None},
+    {50000000, Band::M6, Segment::Cw},
+    {50100000, Band::M6, Segment::Phone},
+    {50300000, Band::M6, Segment::Digital},
+    {50400000, Band::M6, Segment::Phone},
+    {54000000, Band::None, Segment::None},
+    {144000000, Band::M2, Segment::Cw},
+    {144150000, Band::M2, Segment::Digital},
+    {144200000, Band::M2, Segment::Phone},
+    {148000000, Band::None, Segment::None},
+};
+
+inline constexpr int kSegmentCount = int(sizeof(kSegments) / sizeof(kSegments[0]));
+inline constexpr int kBandCount = int(Band::M2);
+
+constexpr const BandSegment &segmentAt(qint64 hz)
+{
+    // Last entry whose start is <= hz.
+    int low = 0;
+    int high = kSegmentCount;
+    while (high - low > 1) {
+        const int mid = (low + high) / 2;
+        if (kSegments[mid].startHz <= hz) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return kSegments[low];
+}
+
+constexpr Band bandForHz(qint64 hz)
+{
+    return segmentAt(hz).band;
+}
+
+constexpr Segment segmentForHz(qint64 hz)
+{
+    return segmentAt(hz).segment;
+}
+
+// Band edges as [lowHz, highHz); 0 for Band::None.
+constexpr qint64 bandLowHz(Band band)
+{
+    for (const BandSegment &segment : kSegments) {
+        if (segment.band == band && band != Band::None) {
+            return segment.startHz;
+        }
+    }
+    return 0;
+}
+
+constexpr qint64 bandHighHz(Band band)
+{
+    for (int i = 0; i + 1 < kSegmentCount; ++i) {
+        if (kSegments[i].band == band && band != Band::None && kSegments[i + 1].band != band) {
+            return kSegments[i + 1].startHz;
+        }
+    }
+    return 0;
+}
+
+constexpr bool bandPlanIsValid()
+{
+    for (int i = 1; i < kSegmentCount; ++i) {
+        if (kSegments[i].startHz <= kSegments[i - 1].startHz) {
+            return false;
+        }
+        // A band is one contiguous run of segments.
+        const Band band = kSegments[i].band;
+        if (band != Band::None && kSegments[i - 1].band != band && bandLowHz(band) != kSegments[i].startHz) {
+            return false;
+        }
+    }
+    return kSegments[0].startHz == 0 && kSegments[kSegmentCount - 1].band == Band::None;
+}
+
+static_assert(bandPlanIsValid(), "kSegments must be sorted with contiguous bands");
+static_assert(bandForHz(14074000) == Band::M20 && segmentForHz(14074000) == Segment::Digital);
+static_assert(bandForHz(7300000) == Band::None && bandHighHz(Band::M40) == 7300000);
+
+// Column name used by the dxcc and modes tables: "160", "80", ..., "2".
+QString bandName(Band band);
+Band bandForName(QStringView name);
+
+// Cluster and RBN frequencies are kHz ("14074.0"), other sources MHz
+// ("14.074"); values above 1000 are taken as kHz. Returns 0 if unparsable.
+qint64 frequencyHz(QStringView text);
+
+#endif // BANDPLAN_H
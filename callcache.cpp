@@ -0,0 +1,109 @@
+#include "callcache.h"
+
+#include <QMutexLocker>
+
+#include <mutex>
+
+CallCache::CallCache(int capacity, int shards)
+{
+    capacity = qMax(1, capacity);
+    m_shardCount = qBound(1, shards, capacity);
+    m_shardCapacity = (capacity + m_shardCount - 1) / m_shardCount;
+    m_shards.reset(new Shard[m_shardCount]);
+    for (int i = 0; i < m_shardCount; ++i) {
+        m_shards[i].entries.reserve(m_shardCapacity);
+        m_shards[i].index.reserve(m_shardCapacity);
+    }
+}
+
+CallCache::~CallCache() = default;
+
+CallCache::Shard &CallCache::shardFor(const QString &call) const
+{
+    return m_shards[qHash(call) % uint(m_shardCount)];
+}
+
+bool CallCache::find(const QString &call, int *value)
+{
+    Shard &shard = shardFor(call);
+    std::unique_lock<QMutex> lock(shard.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        ++m_contended;
+        return false;
+    }
+    auto it = shard.index.constFind(call);
+    if (it == shard.index.constEnd()) {
+        ++shard.misses;
+        return false;
+    }
+    Entry &entry = shard.entries[it.value()];
+    entry.referenced = true;
+    if (value) {
+        *value = entry.value;
+    }
+    ++shard.hits;
+    return true;
+}
+
+void CallCache::insert(const QString &call, int value)
+{
+    Shard &shard = shardFor(call);
+    std::unique_lock<QMutex> lock(shard.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        ++m_contended;
+        return;
+    }
+    auto it = shard.index.constFind(call);
+    if (it != shard.index.constEnd()) {
+        shard.entries[it.value()].value = value;
+        return;
+    }
+
+    int index = shard.entries.size();
+    if (index < m_shardCapacity) {
+        shard.entries.append(Entry());
+    } else {
+        // Sweep the hand past recently used slots, clearing their bit.
+        while (shard.entries.at(shard.hand).referenced) {
+            shard.entries[shard.hand].referenced = false;
+            shard.hand = (shard.hand + 1) % m_shardCapacity;
+        }
+        index = shard.hand;
+        shard.index.remove(shard.entries.at(index).call);
+        ++shard.evictions;
+        shard.hand = (shard.hand + 1) % m_shardCapacity;
+    }
+
+    Entry &entry = shard.entries[index];
+    entry.call = call;
+    entry.value = value;
+    entry.referenced = false;
+    shard.index.insert(call, index);
+}
+
+void CallCache::clear()
+{
+    for (int i = 0; i < m_shardCount; ++i) {
+        Shard &shard = m_shards[i];
+        QMutexLocker locker(&shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+        shard.hand = 0;
+    }
+}
+
+CallCache::Stats CallCache::stats() const
+{
+    Stats stats;
+    for (int i = 0; i < m_shardCount; ++i) {
+        const Shard &shard = m_shards[i];
+        QMutexLocker locker(&shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.evictions += shard.evictions;
+        stats.size += shard.entries.size();
+    }
+    stats.contended = m_contended;
+    stats.capacity = m_shardCount * m_shardCapacity;
+    return stats;
+}
@@ -0,0 +1,66 @@
+#ifndef CALLCACHE_H
+#define CALLCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+// Bounded callsign -> resolution cache with CLOCK (second chance) eviction.
+// Values are opaque record indices owned by the resolver; -1 caches a miss.
+// Calls are spread over shards by hash, each with its own lock and clock
+// hand. A shard that is busy is skipped rather than waited for: find()
+// reports a miss and insert() drops the entry, so callers resolve uncached
+// and never block each other.
+class CallCache
+{
+public:
+    static constexpr int kDefaultShards = 16;
+
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        quint64 contended = 0;  // finds and inserts that skipped a busy shard
+        int size = 0;
+        int capacity = 0;
+    };
+
+    explicit CallCache(int capacity = 4096, int shards = kDefaultShards);
+    ~CallCache();
+
+    bool find(const QString &call, int *value);
+    void insert(const QString &call, int value);
+    void clear();
+    Stats stats() const;
+
+private:
+    struct Entry {
+        QString call;
+        int value = -1;
+        bool referenced = false;
+    };
+
+    // Own cache line each, so shards do not share one between threads.
+    struct alignas(64) Shard {
+        mutable QMutex mutex;
+        int hand = 0;
+        QVector<Entry> entries;
+        QHash<QString, int> index;
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+    };
+
+    Shard &shardFor(const QString &call) const;
+
+    int m_shardCount = 0;
+    int m_shardCapacity = 0;
+    std::unique_ptr<Shard[]> m_shards;
+    std::atomic<quint64> m_contended{0};
+};
+
+#endif // CALLCACHE_H
@@ -0,0 +1,167 @@
+#include "callsign.h"
+
+#include <cstring>
+
+namespace {
+
+ushort codeUnit(QChar c)
+{
+    return c.unicode();
+}
+
+ushort codeUnit(char c)
+{
+    return uchar(c);
+}
+
+bool isSpace(ushort u)
+{
+    return u == ' ' || u == '\t' || u == '\r' || u == '\n';
+}
+
+bool equals(const char *text, int length, const char *literal)
+{
+    return int(std::strlen(literal)) == length && std::memcmp(text, literal, size_t(length)) == 0;
+}
+
+quint8 suffixFlag(const char *text, int length)
+{
+    if (equals(text, length, "P")) return Callsign::Portable;
+    if (equals(text, length, "M")) return Callsign::Mobile;
+    if (equals(text, length, "MM")) return Callsign::MaritimeMobile;
+    if (equals(text, length, "AM")) return Callsign::AeronauticalMobile;
+    if (equals(text, length, "QRP") || equals(text, length, "QRPP")) return Callsign::Qrp;
+    return 0;
+}
+
+}
+
+Callsign::Callsign(QStringView text)
+{
+    parse(text.data(), int(text.size()));
+}
+
+Callsign::Callsign(const char *data, int length)
+{
+    parse(data, length);
+}
+
+template <typename Char>
+void Callsign::parse(const Char *data, int length)
+{
+    int begin = 0;
+    int end = length;
+    while (begin < end && isSpace(codeUnit(data[begin]))) {
+        ++begin;
+    }
+    while (end > begin && isSpace(codeUnit(data[end - 1]))) {
+        --end;
+    }
+
+    int partStart = 0;
+    bool partHasDigit = false;
+    for (int i = begin; i < end; ++i) {
+        const ushort u = codeUnit(data[i]);
+        char c;
+        if (u >= 'a' && u <= 'z') {
+            c = char(u - 'a' + 'A');
+        } else if ((u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') || u == '/') {
+            c = char(u);
+        } else if (u == '-') {
+            break;
+        } else {
+            *this = Callsign();
+            return;
+        }
+        if (m_length >= kMaxLength) {
+            *this = Callsign();
+            return;
+        }
+
+        if (c == '/') {
+            if (!addPart(partStart, partHasDigit)) {
+                *this = Callsign();
+                return;
+            }
+            partStart = m_length + 1;
+            partHasDigit = false;
+        } else if (c >= '0' && c <= '9') {
+            partHasDigit = true;
+        }
+        m_text[m_length++] = c;
+    }
+    if (!addPart(partStart, partHasDigit)) {
+        *this = Callsign();
+        return;
+    }
+    finish();
+}
+
+bool Callsign::addPart(int offset, bool hasDigit)
+{
+    const int length = m_length - offset;
+    if (length <= 0) {
+        return true;
+    }
+    // A lone digit moves the base call to another call area.
+    if (length == 1 && hasDigit) {
+        m_area = m_text[offset];
+        return true;
+    }
+    if (m_partCount == kMaxParts) {
+        return false;
+    }
+    m_parts[m_partCount++] = {quint8(offset), quint8(length), hasDigit};
+    return true;
+}
+
+void Callsign::finish()
+{
+    // The base call is the longest part with a digit; on a tie the later part
+    // wins, so "prefix/call" reads naturally.
+    int base = -1;
+    for (int pass = 0; pass < 2 && base < 0; ++pass) {
+        for (int i = 0; i < m_partCount; ++i) {
+            if ((pass == 0 && !m_parts[i].hasDigit)
+                || (base >= 0 && m_parts[i].length < m_parts[base].length)) {
+                continue;
+            }
+            base = i;
+        }
+    }
+    if (base < 0) {
+        *this = Callsign();
+        return;
+    }
+    m_baseOffset = m_parts[base].offset;
+    m_baseLength = m_parts[base].length;
+
+    // Anything before the base is a location prefix (DL/OG3Z). After it, parts
+    // with a digit are prefixes (OG3Z/OH0) and letters are suffix flags;
+    // unknown letter suffixes such as /A, /B or /LH are ignored.
+    int prefix = base > 0 ? base - 1 : -1;
+    for (int i = base + 1; i < m_partCount; ++i) {
+        const Part &part = m_parts[i];
+        if (part.hasDigit) {
+            if (prefix < 0) {
+                prefix = i;
+            }
+        } else {
+            m_flags |= suffixFlag(m_text + part.offset, part.length);
+        }
+    }
+    if (prefix >= 0) {
+        m_prefixOffset = m_parts[prefix].offset;
+        m_prefixLength = m_parts[prefix].length;
+    }
+
+    if (m_area) {
+        std::memcpy(m_areaBase, m_text + m_baseOffset, m_baseLength);
+        for (int i = 1; i < m_baseLength; ++i) {
+            if (m_areaBase[i] >= '0' && m_areaBase[i] <= '9') {
+                m_areaBase[i] = m_area;
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef CALLSIGN_H
+#define CALLSIGN_H
+
+#include <QLatin1String>
+#include <QStringView>
+
+// A callsign broken into prefix override, base call and suffix flags, e.g.
+// "kh6/k1abc/p" -> prefix KH6, base K1ABC, Portable. Parsing is a single pass
+// over the text into fixed buffers, so it never allocates; parts are views
+// into the uppercased call. Anything after '-' (cluster SSIDs such as
+// "OH6BG-#") is ignored.
+class Callsign
+{
+public:
+    enum Flag : quint8 {
+        Portable = 0x01,
+        Mobile = 0x02,
+        MaritimeMobile = 0x04,
+        AeronauticalMobile = 0x08,
+        Qrp = 0x10,
+    };
+
+    static constexpr int kMaxLength = 32;
+
+    Callsign() = default;
+    explicit Callsign(QStringView text);
+    Callsign(const char *data, int length);
+
+    bool isValid() const { return m_baseLength > 0; }
+
+    // Uppercased call as written, without whitespace or SSID.
+    QLatin1String call() const { return QLatin1String(m_text, m_length); }
+    QLatin1String base() const { return QLatin1String(m_text + m_baseOffset, m_baseLength); }
+    // Location prefix written before or after the base call, e.g. OH0 in OG3Z/OH0.
+    QLatin1String prefix() const { return QLatin1String(m_text + m_prefixOffset, m_prefixLength); }
+    // Call-area digit from a "/4" part, or 0.
+    char area() const { return m_area; }
+    // Base call with its call-area digit replaced by area(): UA9ABC/1 -> UA1ABC.
+    QLatin1String areaBase() const { return QLatin1String(m_areaBase, m_area ? m_baseLength : 0); }
+
+    quint8 flags() const { return m_flags; }
+    bool has(Flag flag) const { return (m_flags & flag) != 0; }
+    // Maritime and aeronautical mobile stations are in no DXCC entity.
+    bool isOffshore() const { return (m_flags & (MaritimeMobile | AeronauticalMobile)) != 0; }
+
+private:
+    struct Part {
+        quint8 offset;
+        quint8 length;
+        bool hasDigit;
+    };
+    static constexpr int kMaxParts = 4;
+
+    template <typename Char>
+    void parse(const Char *data, int length);
+    bool addPart(int offset, bool hasDigit);
+    void finish();
+
+    char m_text[kMaxLength] = {};
+    char m_areaBase[kMaxLength] = {};
+    Part m_parts[kMaxParts] = {};
+    quint8 m_partCount = 0;
+    quint8 m_length = 0;
+    quint8 m_baseOffset = 0;
+    quint8 m_baseLength = 0;
+    quint8 m_prefixOffset = 0;
+    quint8 m_prefixLength = 0;
+    quint8 m_flags = 0;
+    char m_area = 0;
+};
+
+#endif // CALLSIGN_H
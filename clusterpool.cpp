@@ -0,0 +1,233 @@
+#include "clusterpool.h"
+#include "spotdeduper.h"
+#include "tcpreceiver.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QLoggingCategory>
+#include <QSettings>
+
+// Per-node stats every evaluation; enable with QT_LOGGING_RULES="hamvibe.cluster.debug=true".
+Q_LOGGING_CATEGORY(lcClusterPool, "hamvibe.cluster", QtInfoMsg)
+
+namespace {
+
+constexpr double kLatencyWeight = 0.2;
+constexpr double kDisconnectPenalty = 5.0;
+
+}
+
+QVector<ClusterNode> ClusterPool::nodesFromSettings(QSettings &settings)
+{
+    QVector<ClusterNode> nodes;
+    const int count = settings.beginReadArray("cluster/nodes");
+    for (int i = 0; i < count; ++i) {
+        settings.setArrayIndex(i);
+        ClusterNode node;
+        node.host = settings.value("host").toString().trimmed();
+        node.port = static_cast<quint16>(settings.value("port", 7300).toUInt());
+        node.login = settings.value("login", "og3z").toString().trimmed();
+        if (node.host.isEmpty() || node.port == 0 || node.login.isEmpty()) {
+            qWarning() << "Skipping cluster node" << i << "without host, port or login";
+            continue;
+        }
+        nodes.append(node);
+    }
+    settings.endArray();
+
+    if (nodes.isEmpty()) {
+        nodes.append({"ham.connect.fi", 7300, "og3z"});
+    }
+    return nodes;
+}
+
+double ClusterPool::score(const ClusterNodeHealth &health)
+{
+    return health.spotLines - health.latencyMs / 1000.0 - kDisconnectPenalty * health.disconnects;
+}
+
+ClusterPool::ClusterPool(const QVector<ClusterNode> &nodes, SpotDeduper *deduper, QObject *parent)
+    : QObject(parent)
+    , m_nodes(nodes)
+    , m_health(nodes.size())
+    , m_deduper(deduper)
+    , m_evaluateTimer(this)
+{
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        const ClusterNode &node = m_nodes.at(i);
+        auto *receiver = new TcpReceiver(node.host, node.port, node.login, this);
+        connect(receiver, &TcpReceiver::connectionChanged, this, [this, i](bool connected) {
+            onConnectionChanged(i, connected);
+        });
+        // Rate and silence go by every line, not the few that are needed.
+        connect(receiver, &TcpReceiver::spotLineReceived, this, [this, i]() {
+            ++m_health[i].spotLines;
+        });
+        connect(receiver, &TcpReceiver::spotReceived, this,
+                [this, i](const QString &time, const QString &call, const QString &freq,
+                          const QString &mode, const QString &country, int dxcc,
+                          const QString &spotter, const QString &message) {
+                    DxSpot spot;
+                    spot.time = time;
+                    spot.call = call;
+                    spot.freq = freq;
+                    spot.mode = mode;
+                    spot.country = country;
+                    spot.dxcc = dxcc;
+                    spot.spotter = spotter;
+                    spot.message = message;
+                    spot.epoch = QDateTime::currentSecsSinceEpoch();
+                    spot.hz = frequencyHz(freq);
+                    spot.band = bandForHz(spot.hz);
+                    spot.modeGroup = spotModeForName(mode);
+                    spot.continent = continentForName(spotter);
+                    onSpot(i, spot);
+                });
+        m_receivers.append(receiver);
+    }
+
+    m_evaluateTimer.setInterval(kEvaluateIntervalMs);
+    connect(&m_evaluateTimer, &QTimer::timeout, this, [this]() {
+        evaluate(QDateTime::currentMSecsSinceEpoch());
+    });
+}
+
+void ClusterPool::setNeededMatrix(const NeededMatrix *matrix)
+{
+    for (TcpReceiver *receiver : m_receivers) {
+        receiver->setNeededMatrix(matrix);
+    }
+}
+
+void ClusterPool::start()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < m_nodes.size() && i < m_maxActive; ++i) {
+        activate(i, now);
+    }
+    m_evaluateTimer.start();
+}
+
+void ClusterPool::stop()
+{
+    m_evaluateTimer.stop();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        if (m_health.at(i).active) {
+            deactivate(i, now);
+        }
+    }
+}
+
+void ClusterPool::onSpot(int index, const DxSpot &spot)
+{
+    ClusterNodeHealth &health = m_health[index];
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    SpotDeduper::Origin origin;
+    const bool fresh = m_deduper->offer(spot, now, index, &origin);
+
+    // A node's own re-spots say nothing about its lag behind the others.
+    const qint64 lag = now - origin.passedMs;
+    if ((fresh || origin.source != index) && lag <= kMaxLatencySampleMs) {
+        health.latencyMs += kLatencyWeight * (lag - health.latencyMs);
+    }
+    if (fresh) {
+        emit spotReceived(spot);
+    }
+}
+
+void ClusterPool::onConnectionChanged(int index, bool connected)
+{
+    ClusterNodeHealth &health = m_health[index];
+    if (!connected && health.connected && health.active) {
+        ++health.disconnects;
+    }
+    health.connected = connected;
+    health.changedMs = QDateTime::currentMSecsSinceEpoch();
+}
+
+bool ClusterPool::isFailing(int index, qint64 nowMs) const
+{
+    const ClusterNodeHealth &health = m_health.at(index);
+    if (!health.connected) {
+        return nowMs - health.changedMs > kReconnectGraceMs;
+    }
+    if (health.latencyMs > kSlowLatencyMs) {
+        return true;
+    }
+    if (health.spotLines > 0 || nowMs - health.changedMs < kEvaluateIntervalMs) {
+        return false;
+    }
+    // Silent while another node delivers: the session is probably stuck.
+    for (int i = 0; i < m_health.size(); ++i) {
+        if (i != index && m_health.at(i).active && m_health.at(i).spotLines > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ClusterPool::evaluate(qint64 nowMs)
+{
+    const auto bestStandby = [this]() {
+        int best = -1;
+        for (int i = 0; i < m_health.size(); ++i) {
+            if (!m_health.at(i).active && (best < 0 || score(m_health.at(i)) > score(m_health.at(best)))) {
+                best = i;
+            }
+        }
+        return best;
+    };
+
+    QVector<int> failing;
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        if (m_health.at(i).active && isFailing(i, nowMs)) {
+            failing.append(i);
+        }
+    }
+    for (const int i : failing) {
+        const int standby = bestStandby();
+        if (standby < 0) {
+            break;
+        }
+        qWarning() << "Cluster failover:" << m_nodes.at(i).host << "->" << m_nodes.at(standby).host;
+        deactivate(i, nowMs);
+        activate(standby, nowMs);
+    }
+
+    int active = 0;
+    for (int i = 0; i < m_health.size(); ++i) {
+        active += m_health.at(i).active ? 1 : 0;
+    }
+    for (int standby = bestStandby(); active < m_maxActive && standby >= 0; standby = bestStandby()) {
+        activate(standby, nowMs);
+        ++active;
+    }
+
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        ClusterNodeHealth &health = m_health[i];
+        if (health.active) {
+            qCDebug(lcClusterPool).noquote() << "Cluster node" << m_nodes.at(i).host
+                                             << "lines/min" << health.spotLines
+                                             << "latency ms" << qRound(health.latencyMs)
+                                             << "disconnects" << health.disconnects;
+        }
+        health.spotLines = 0;
+    }
+}
+
+void ClusterPool::activate(int index, qint64 nowMs)
+{
+    ClusterNodeHealth &health = m_health[index];
+    health.active = true;
+    health.changedMs = nowMs;
+    m_receivers.at(index)->start();
+}
+
+void ClusterPool::deactivate(int index, qint64 nowMs)
+{
+    ClusterNodeHealth &health = m_health[index];
+    health.active = false;
+    health.changedMs = nowMs;
+    m_receivers.at(index)->stop();
+}
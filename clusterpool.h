@@ -0,0 +1,88 @@
+#ifndef CLUSTERPOOL_H
+#define CLUSTERPOOL_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include "dxspot.h"
+
+class NeededMatrix;
+class QSettings;
+class SpotDeduper;
+class TcpReceiver;
+
+// One DX cluster node from the settings.
+struct ClusterNode
+{
+    QString host;
+    quint16 port = 0;
+    QString login;
+};
+
+// What the pool knows about a node, for scoring and failover.
+struct ClusterNodeHealth
+{
+    bool active = false;        // should be connected
+    bool connected = false;
+    int disconnects = 0;
+    int spotLines = 0;          // DX lines this evaluation period, needed or not
+    double latencyMs = 0.0;     // behind the first node to deliver a spot, averaged
+    qint64 changedMs = 0;       // last connect, disconnect or activation
+};
+
+// Ingests spots from several cluster nodes at once and merges them through
+// a shared SpotDeduper. Up to maxActive nodes are connected; every
+// kEvaluateIntervalMs a node that is down, silent or slow is replaced by
+// the best-scoring standby node.
+class ClusterPool : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int kDefaultMaxActive = 2;
+    static constexpr int kEvaluateIntervalMs = 60000;
+    static constexpr qint64 kReconnectGraceMs = 30000;
+    static constexpr double kSlowLatencyMs = 30000.0;
+    // A copy arriving later than this is a fresh re-spot, not lag.
+    static constexpr qint64 kMaxLatencySampleMs = 120000;
+
+    // Reads the "cluster/nodes" array; the built-in node when it is empty.
+    static QVector<ClusterNode> nodesFromSettings(QSettings &settings);
+    // Higher is better: line rate, less latency and fewer disconnects.
+    static double score(const ClusterNodeHealth &health);
+
+    ClusterPool(const QVector<ClusterNode> &nodes, SpotDeduper *deduper, QObject *parent = nullptr);
+
+    void setNeededMatrix(const NeededMatrix *matrix);
+    void setMaxActive(int count) { m_maxActive = qMax(1, count); }
+
+    void start();
+    void stop();
+    // Replaces failing nodes; runs every kEvaluateIntervalMs on its own.
+    void evaluate(qint64 nowMs);
+
+    const ClusterNode &node(int index) const { return m_nodes.at(index); }
+    const ClusterNodeHealth &health(int index) const { return m_health.at(index); }
+    int size() const { return m_nodes.size(); }
+
+signals:
+    // A spot no other node has delivered within the dedupe window.
+    void spotReceived(const DxSpot &spot);
+
+private:
+    void onSpot(int index, const DxSpot &spot);
+    void onConnectionChanged(int index, bool connected);
+    bool isFailing(int index, qint64 nowMs) const;
+    void activate(int index, qint64 nowMs);
+    void deactivate(int index, qint64 nowMs);
+
+    QVector<ClusterNode> m_nodes;
+    QVector<ClusterNodeHealth> m_health;
+    QVector<TcpReceiver *> m_receivers;
+    SpotDeduper *m_deduper = nullptr;
+    int m_maxActive = kDefaultMaxActive;
+    QTimer m_evaluateTimer;
+};
+
+#endif // CLUSTERPOOL_H
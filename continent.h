@@ -0,0 +1,29 @@
+#ifndef CONTINENT_H
+#define CONTINENT_H
+
+#include <QLatin1String>
+#include <QStringView>
+
+#include <iterator>
+
+// Continent as cty.dat abbreviates it, stored as a small int.
+enum class Continent : quint8 {
+    None,
+    Af, An, As, Eu, Na, Oc, Sa,
+};
+
+inline constexpr const char *kContinentNames[] = {"", "AF", "AN", "AS", "EU", "NA", "OC", "SA"};
+
+// "EU", " eu " -> Continent::Eu; None for anything else.
+inline Continent continentForName(QStringView name)
+{
+    const QStringView trimmed = name.trimmed();
+    for (int i = 1; i < int(std::size(kContinentNames)); ++i) {
+        if (trimmed.compare(QLatin1String(kContinentNames[i]), Qt::CaseInsensitive) == 0) {
+            return static_cast<Continent>(i);
+        }
+    }
+    return Continent::None;
+}
+
+#endif // CONTINENT_H
@@ -1,175 +1,1143 @@
 #include "country.h"
+#include "callsign.h"
+#include "dxccentity.h"
 
-#include <QFile>
+#include <QCryptographicHash>
 #include <QDebug>
-#include <QTextStream>
-#include <QRegularExpression>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+constexpr char kImageMagic[8] = {'H', 'V', 'C', 'T', 'Y', 'I', 'M', 'G'};
+constexpr quint32 kImageVersion = 4;
+constexpr quint32 kByteOrderMark = 0x01020304;
+constexpr int kHashSize = 20;
+// Distinct calls per worker below which a batch is not worth splitting.
+constexpr int kBatchChunkSize = 4096;
 
-void Country::init()
+// On-disk layout of a compiled cty.dat image. All sections are 8-byte
+// aligned and stored in host byte order; the byte-order mark rejects
+// images written on a machine with a different endianness.
+struct ImageHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    char ctyHash[kHashSize];
+    quint32 entityCount;
+    quint32 entitiesOffset;
+    quint32 detailCount;
+    quint32 detailsOffset;
+    quint32 callCount;
+    quint32 callsOffset;
+    quint32 nodeCount;
+    quint32 nodesOffset;
+    quint32 stringsLength; // UTF-16 code units
+    quint32 stringsOffset;
+    quint32 totalSize;
+};
+
+struct ImageEntity {
+    quint32 nameOffset;
+    quint32 nameLength;
+    quint32 displayOffset;
+    quint32 displayLength;
+    qint32 dxcc;
+};
+
+struct Field {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+};
+
+int alphabetSlot(ushort u)
 {
-    QFile file("cty.dat");
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Failed to open cty.dat";
-        return;
+    if (u >= '0' && u <= '9') {
+        return u - '0';
+    }
+    if (u >= 'A' && u <= 'Z') {
+        return 10 + (u - 'A');
     }
+    if (u == '/') {
+        return 36;
+    }
+    return -1;
+}
 
-    QTextStream in(&file);
-    const QString content = in.readAll();
-    ParseCty(content);
+quint32 alignOffset(quint64 offset)
+{
+    return static_cast<quint32>((offset + 7u) & ~quint64(7u));
 }
 
-void Country::ParseCty(const QString &content)
+bool sectionFits(quint32 offset, quint64 count, quint64 elementSize, qint64 size)
 {
-    const QStringList blocks = content.split(';', Qt::SkipEmptyParts);
-    for (const QString &block : blocks) {
-        const QString trimmedBlock = block.trimmed();
-        if (trimmedBlock.isEmpty()) {
-            continue;
+    return offset % 4 == 0 && quint64(offset) + count * elementSize <= quint64(size);
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+char toUpperAscii(char c)
+{
+    return (c >= 'a' && c <= 'z') ? char(c - 'a' + 'A') : c;
+}
+
+Field trimmed(const char *begin, const char *end)
+{
+    while (begin < end && isBlank(*begin)) {
+        ++begin;
+    }
+    while (end > begin && isBlank(end[-1])) {
+        --end;
+    }
+    return {begin, end};
+}
+
+// Locale-independent decimal parser for the numeric cty.dat fields.
+double parseDecimal(const char *begin, const char *end)
+{
+    const Field field = trimmed(begin, end);
+    const char *p = field.begin;
+    bool negative = false;
+    if (p < field.end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    double value = 0.0;
+    while (p < field.end && *p >= '0' && *p <= '9') {
+        value = value * 10.0 + (*p - '0');
+        ++p;
+    }
+    if (p < field.end && *p == '.') {
+        ++p;
+        double scale = 0.1;
+        while (p < field.end && *p >= '0' && *p <= '9') {
+            value += (*p - '0') * scale;
+            scale *= 0.1;
+            ++p;
         }
+    }
+    return negative ? -value : value;
+}
 
-        const QStringList lines = trimmedBlock.split(QRegularExpression(R"(\r?\n)"), Qt::SkipEmptyParts);
-        if (lines.isEmpty()) {
-            continue;
+void copyContinent(char *out, const char *begin, const char *end)
+{
+    const Field field = trimmed(begin, end);
+    std::memset(out, 0, 4);
+    for (int i = 0; i < 3 && field.begin + i < field.end; ++i) {
+        out[i] = toUpperAscii(field.begin[i]);
+    }
+}
+
+QString continentName(const char *continent)
+{
+    static const QString kContinents[] = {"AF", "AN", "AS", "EU", "NA", "OC", "SA"};
+    const QLatin1String code(continent, int(qstrnlen(continent, 4)));
+    for (const QString &known : kContinents) {
+        if (known == code) {
+            return known;
         }
+    }
+    return QString(code);
+}
 
-        const QString header = lines.first().trimmed();
-        const QStringList headerParts = header.split(':', Qt::SkipEmptyParts);
-        if (headerParts.size() < 8) {
-            continue;
+quint64 mixHash(quint64 h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+std::shared_ptr<const Country> &currentCountry()
+{
+    static std::shared_ptr<const Country> country;
+    return country;
+}
+
+std::once_flag &currentCountryOnce()
+{
+    static std::once_flag once;
+    return once;
+}
+
+}
+
+QVector<Country::Source> Country::defaultSources()
+{
+    return {
+        {CtyLayer, kCtyFile},
+        {BigCtyLayer, kBigCtyFile},
+        {OverrideLayer, kOverrideFile},
+        {SpecialEventLayer, kSpecialEventFile},
+        {ExceptionLayer, kExceptionFile},
+    };
+}
+
+QString Country::layerName(Layer layer)
+{
+    switch (layer) {
+    case CtyLayer: return "cty.dat";
+    case BigCtyLayer: return "big cty.dat";
+    case OverrideLayer: return "override";
+    case SpecialEventLayer: return "special event";
+    case ExceptionLayer: return "exception";
+    case LayerCount: break;
+    }
+    return QString();
+}
+
+bool Country::init(const QVector<Source> &sources)
+{
+    QVector<QByteArray> contents(sources.size());
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (int i = 0; i < sources.size(); ++i) {
+        QFile file(sources.at(i).path);
+        if (file.open(QIODevice::ReadOnly)) {
+            contents[i] = file.readAll();
+        } else if (i == 0) {
+            qWarning() << "Failed to open" << sources.at(i).path;
+            return false;
         }
+        const qint32 layer = sources.at(i).layer;
+        hash.addData(reinterpret_cast<const char *>(&layer), sizeof(layer));
+        hash.addData(QCryptographicHash::hash(contents.at(i), QCryptographicHash::Sha1));
+    }
+    const QByteArray sourceHash = hash.result();
+    m_sourceHash = sourceHash;
 
-        const QString country = headerParts.at(0).trimmed();
-        const QString continent = headerParts.at(3).trimmed();
-        const QString headerPrefix = headerParts.at(7).trimmed();
-        if (headerPrefix.startsWith('*')) {
-            continue;
+    const QString snapshot = snapshotPath(sourceHash);
+    if (loadSnapshot(snapshot, sourceHash)) {
+        return true;
+    }
+
+    for (int i = 0; i < sources.size(); ++i) {
+        const Layer layer = sources.at(i).layer;
+        if (layer == SpecialEventLayer || layer == ExceptionLayer) {
+            addCalls(contents.at(i), layer);
+        } else {
+            addCty(contents.at(i), layer);
+        }
+    }
+    compile();
+    QDir().mkpath(QFileInfo(snapshot).absolutePath());
+    if (saveSnapshot(snapshot, sourceHash)) {
+        removeStaleSnapshots(snapshot);
+    }
+    return true;
+}
+
+std::shared_ptr<const Country> Country::shared()
+{
+    std::call_once(currentCountryOnce(), [] {
+        auto country = std::make_shared<Country>();
+        country->init();
+        std::atomic_store(&currentCountry(), std::shared_ptr<const Country>(std::move(country)));
+    });
+    return std::atomic_load(&currentCountry());
+}
+
+void Country::publish(std::shared_ptr<const Country> country)
+{
+    std::call_once(currentCountryOnce(), [] {});
+    std::atomic_store(&currentCountry(), std::move(country));
+}
+
+int Country::changedEntities(const Country &before, const Country &after)
+{
+    const QHash<QString, quint64> old = before.entityFingerprints();
+    const QHash<QString, quint64> current = after.entityFingerprints();
+
+    int changed = 0;
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        auto previous = old.constFind(it.key());
+        if (previous == old.constEnd() || previous.value() != it.value()) {
+            ++changed;
+        }
+    }
+    for (auto it = old.constBegin(); it != old.constEnd(); ++it) {
+        if (!current.contains(it.key())) {
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+QHash<QString, quint64> Country::entityFingerprints() const
+{
+    // Entity indexes are not stable across builds, so details are hashed by
+    // value and prefixes by their spelling. Sums keep the result order-free.
+    auto detailHash = [this](int index) {
+        const Detail &detail = m_imageDetails[index];
+        const float values[] = {float(detail.cqZone), float(detail.ituZone),
+                                detail.latitude, detail.longitude, detail.utcOffset};
+        quint64 h = qHashBits(values, sizeof(values));
+        h = h * 31 + qHashBits(detail.continent, sizeof(detail.continent));
+        return mixHash(h);
+    };
+
+    QHash<QString, quint64> prints;
+    prints.reserve(m_displayNames.size());
+    QVector<bool> seen(m_displayNames.size(), false);
+    for (int i = 0; i < m_detailCount; ++i) {
+        // The first detail of an entity is its header.
+        const int entity = m_imageDetails[i].entity;
+        if (!seen.at(entity)) {
+            seen[entity] = true;
+            prints[m_displayNames.at(entity)] += detailHash(i);
+        }
+    }
+    for (int i = 0; i < m_callCount; ++i) {
+        const ExactCall &call = m_calls[i];
+        const quint64 h = mixHash(qHashBits(call.call, sizeof(call.call)) * 31 + detailHash(call.detail));
+        prints[m_displayNames.at(m_imageDetails[call.detail].entity)] += h;
+    }
+
+    static const char kAlphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/";
+    struct Frame {
+        qint32 node;
+        int parentLength;
+        char letter;
+    };
+    QVector<Frame> stack;
+    QByteArray prefix;
+    if (m_nodeCount > 0) {
+        stack.append({0, 0, '\0'});
+    }
+    while (!stack.isEmpty()) {
+        const Frame frame = stack.takeLast();
+        prefix.truncate(frame.parentLength);
+        if (frame.letter) {
+            prefix.append(frame.letter);
+        }
+        const PrefixNode &node = m_nodes[frame.node];
+        if (node.detail >= 0) {
+            const quint64 h = mixHash(qHash(prefix) * 31 + detailHash(node.detail));
+            prints[m_displayNames.at(m_imageDetails[node.detail].entity)] += h;
         }
-        if (!country.isEmpty() && !continent.isEmpty()) {
-            countryContinent.insert(country.toUpper(), continent.toUpper());
+        if (prefix.size() >= 64) {
+            continue; // no real prefix is this long; guards against a cyclic image
         }
-        QStringList prefixes;
-        if (!headerPrefix.isEmpty()) {
-            prefixes << headerPrefix;
+        for (int slot = kPrefixSlots - 1; slot >= 0; --slot) {
+            if (node.children[slot] >= 0) {
+                stack.append({node.children[slot], int(prefix.size()), kAlphabet[slot]});
+            }
+        }
+    }
+    return prints;
+}
+
+QString Country::snapshotPath(const QByteArray &ctyHash)
+{
+    const QString name = QString("cty-%1.bin").arg(QString::fromLatin1(ctyHash.left(8).toHex()));
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(name);
+}
+
+void Country::removeStaleSnapshots(const QString &current)
+{
+    // A snapshot the running resolver still maps cannot be removed on
+    // Windows; it goes on a later start instead.
+    const QFileInfo info(current);
+    QDir dir = info.absoluteDir();
+    const QStringList stale = dir.entryList({"cty-*.bin", "cty.bin"}, QDir::Files);
+    for (const QString &name : stale) {
+        if (name != info.fileName()) {
+            dir.remove(name);
         }
+    }
+}
+
+bool Country::saveSnapshot(const QString &path, const QByteArray &ctyHash) const
+{
+    if (m_image.isEmpty() || ctyHash.size() != kHashSize) {
+        return false;
+    }
+
+    QByteArray image = m_image;
+    std::memcpy(image.data() + offsetof(ImageHeader, ctyHash), ctyHash.constData(), kHashSize);
 
-        QStringList calls;
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to create cty.dat snapshot:" << path << file.errorString();
+        return false;
+    }
+    if (file.write(image) != image.size()) {
+        qWarning() << "Failed to write cty.dat snapshot:" << path << file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        qWarning() << "Failed to replace cty.dat snapshot:" << path << file.errorString();
+        return false;
+    }
+    return true;
+}
 
-        QString rest;
-        for (int i = 1; i < lines.size(); ++i) {
-            if (!rest.isEmpty()) {
-                rest.append(',');
+bool Country::loadSnapshot(const QString &path, const QByteArray &ctyHash)
+{
+    auto file = std::make_shared<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = file->size();
+    if (size < qint64(sizeof(ImageHeader)) || ctyHash.size() != kHashSize) {
+        return false;
+    }
+    const uchar *data = file->map(0, size);
+    if (!data) {
+        qWarning() << "Failed to map cty.dat snapshot:" << path << file->errorString();
+        return false;
+    }
+
+    const char *image = reinterpret_cast<const char *>(data);
+    if (std::memcmp(image + offsetof(ImageHeader, ctyHash), ctyHash.constData(), kHashSize) != 0) {
+        return false;
+    }
+    if (!attachImage(image, size)) {
+        qWarning() << "Ignoring invalid cty.dat snapshot:" << path;
+        return false;
+    }
+
+    m_snapshotFile = file;
+    m_cache->clear();
+    m_image.clear();
+    m_prefixNodes.clear();
+    m_exactCalls.clear();
+    m_details.clear();
+    m_entityNames.clear();
+    m_entityCodes.clear();
+    m_entityDetails.clear();
+    m_entityIndex.clear();
+    m_zoneOverrides.clear();
+    return true;
+}
+
+void Country::ParseCty(const QString &content)
+{
+    ParseCty(content.toUtf8());
+}
+
+void Country::ParseCty(const QByteArray &content)
+{
+    addCty(content, CtyLayer);
+    compile();
+}
+
+void Country::addCty(const QByteArray &content, Layer layer)
+{
+    m_layer = layer;
+    const char *p = content.constData();
+    const char *const end = p + content.size();
+
+    while (p < end) {
+        while (p < end && (isBlank(*p) || *p == ';')) {
+            ++p;
+        }
+        if (p >= end) {
+            break;
+        }
+
+        // Header line: name:cq:itu:continent:lat:lon:utc:prefix:
+        const char *lineEnd = p;
+        while (lineEnd < end && *lineEnd != '\n' && *lineEnd != ';') {
+            ++lineEnd;
+        }
+        std::array<Field, 8> fields;
+        int fieldCount = 0;
+        const char *fieldStart = p;
+        for (const char *q = p; fieldCount < int(fields.size()); ++q) {
+            if (q == lineEnd || *q == ':') {
+                if (q > fieldStart) {
+                    fields[fieldCount++] = trimmed(fieldStart, q);
+                }
+                fieldStart = q + 1;
+                if (q == lineEnd) {
+                    break;
+                }
             }
-            rest.append(lines.at(i));
         }
+        p = lineEnd;
 
-        const QStringList tokens = rest.split(',', Qt::SkipEmptyParts);
-        for (QString token : tokens) {
-            token = token.trimmed();
-            if (token.isEmpty()) {
+        const Field &headerPrefix = fields[7];
+        const bool valid = fieldCount == int(fields.size())
+                           && !(headerPrefix.begin < headerPrefix.end && *headerPrefix.begin == '*');
+        int baseDetail = -1;
+        if (valid) {
+            Detail detail;
+            std::memset(&detail, 0, sizeof(detail));
+            detail.cqZone = qint16(parseDecimal(fields[1].begin, fields[1].end));
+            detail.ituZone = qint16(parseDecimal(fields[2].begin, fields[2].end));
+            copyContinent(detail.continent, fields[3].begin, fields[3].end);
+            detail.latitude = float(parseDecimal(fields[4].begin, fields[4].end));
+            detail.longitude = float(parseDecimal(fields[5].begin, fields[5].end));
+            detail.utcOffset = float(parseDecimal(fields[6].begin, fields[6].end));
+
+            const QString name = QString::fromUtf8(fields[0].begin, int(fields[0].end - fields[0].begin));
+            const DxccEntity *dxcc = dxccEntityForCtyPrefix(
+                QByteArray::fromRawData(headerPrefix.begin, int(headerPrefix.end - headerPrefix.begin)));
+            baseDetail = m_entityDetails.at(internEntity(name, dxcc ? dxcc->code : 0, detail));
+            addToken(headerPrefix.begin, headerPrefix.end, baseDetail);
+        }
+
+        // Body: prefixes and =calls separated by commas and line breaks, up to ';'.
+        while (p < end && *p != ';') {
+            if (*p == ',' || isBlank(*p)) {
+                ++p;
                 continue;
             }
-            const bool isCall = token.startsWith('=');
-            if (isCall) {
-                token.remove(0, 1);
-            }
-            token.replace(QRegularExpression(R"(\(.*?\))"), "");
-            token.replace(QRegularExpression(R"(\[.*?\])"), "");
-            token = token.trimmed();
-            if (token.isEmpty()) {
-                continue;
+            const char *tokenStart = p;
+            while (p < end && *p != ',' && *p != ';' && *p != '\n' && *p != '\r') {
+                ++p;
             }
-            if (isCall) {
-                calls << token;
-            } else {
-                prefixes << token;
+            if (valid) {
+                addToken(tokenStart, p, baseDetail);
             }
         }
+    }
+}
 
-        for (const QString &call : calls) {
-            callMap.insert(call.toUpper(), country);
+void Country::addCalls(const QByteArray &csv, Layer layer)
+{
+    // One "call,country" line per call; the country is a cty.dat or DXCC
+    // entity name, or an ADIF code. Header and comment lines are skipped.
+    m_layer = layer;
+    const QList<QByteArray> lines = csv.split('\n');
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(',');
+        const QByteArray callField = fields.at(0).trimmed();
+        if (fields.size() < 2 || callField.startsWith('#')
+            || std::none_of(callField.begin(), callField.end(), isDigit)) {
+            continue;
         }
-        for (const QString &prefix : prefixes) {
-            prefixMap.insert(prefix.toUpper(), country);
+        const Callsign call(callField.constData(), callField.size());
+        const QString country = QString::fromUtf8(fields.at(1).trimmed());
+        const int entity = call.isValid() ? entityForName(country) : -1;
+        if (entity < 0) {
+            qWarning() << "Call list entry not indexed:" << line.trimmed();
+            continue;
         }
+        insertExactCall(call.call().data(), call.call().size(), m_entityDetails.at(entity));
+    }
+}
 
-        // qDebug().noquote() << "CTY" << country << continent
-        //                    << "prefixes" << prefixes.join(",")
-        //                    << "calls" << calls.join(",");
+int Country::entityForName(const QString &name) const
+{
+    bool isCode = false;
+    int dxcc = name.toInt(&isCode);
+    if (!isCode) {
+        const DxccEntity *entity = dxccEntityForName(name);
+        dxcc = entity ? entity->code : 0;
+    }
+    if (dxcc != 0) {
+        const int entity = m_entityCodes.indexOf(dxcc);
+        if (entity >= 0) {
+            return entity;
+        }
+    }
+    for (int i = 0; i < m_entityNames.size(); ++i) {
+        if (!m_entityNames.at(i).isEmpty() && m_entityNames.at(i).compare(name, Qt::CaseInsensitive) == 0) {
+            return i;
+        }
     }
+    return -1;
 }
 
-QString Country::GetCountry(const QString &call, QString *continent) const
+void Country::addToken(const char *begin, const char *end, int baseDetail)
 {
-    const QString key = call.toUpper();
+    char call[32];
+    int length = 0;
+    bool overflow = false;
+    bool isCall = false;
+    bool overridden = false;
+    bool zonesOnly = true;
+    Detail detail = m_details.at(baseDetail);
+
+    const char *p = begin;
+    if (p < end && *p == '=') {
+        isCall = true;
+        ++p;
+    }
+
+    auto group = [&p, end](char close) -> Field {
+        const char *groupEnd = p + 1;
+        while (groupEnd < end && *groupEnd != close) {
+            ++groupEnd;
+        }
+        const Field field{p + 1, groupEnd};
+        p = groupEnd < end ? groupEnd + 1 : end;
+        return field;
+    };
 
-    auto resolve = [&](const QString &k) -> QString {
-        const QString direct = callMap.value(k, QString());
-        if (!direct.isEmpty()) {
-            return direct;
-        }
-        QString best;
-        for (auto it = prefixMap.constBegin(); it != prefixMap.constEnd(); ++it) {
-            const QString &prefix = it.key();
-            if (k.startsWith(prefix)) {
-                if (prefix.size() > best.size()) {
-                    best = prefix;
+    while (p < end) {
+        switch (*p) {
+        case '(': {
+            const Field field = group(')');
+            detail.cqZone = qint16(parseDecimal(field.begin, field.end));
+            overridden = true;
+            break;
+        }
+        case '[': {
+            const Field field = group(']');
+            detail.ituZone = qint16(parseDecimal(field.begin, field.end));
+            overridden = true;
+            break;
+        }
+        case '<': {
+            const Field field = group('>');
+            const char *slash = std::find(field.begin, field.end, '/');
+            detail.latitude = float(parseDecimal(field.begin, slash));
+            detail.longitude = float(parseDecimal(slash < field.end ? slash + 1 : field.end, field.end));
+            overridden = true;
+            zonesOnly = false;
+            break;
+        }
+        case '{': {
+            const Field field = group('}');
+            copyContinent(detail.continent, field.begin, field.end);
+            overridden = true;
+            zonesOnly = false;
+            break;
+        }
+        case '~': {
+            const Field field = group('~');
+            detail.utcOffset = float(parseDecimal(field.begin, field.end));
+            overridden = true;
+            zonesOnly = false;
+            break;
+        }
+        default:
+            if (!isBlank(*p)) {
+                if (length < int(sizeof(call))) {
+                    call[length++] = toUpperAscii(*p);
+                } else {
+                    overflow = true;
                 }
             }
+            ++p;
+            break;
+        }
+    }
+
+    if (length == 0) {
+        return;
+    }
+    if (overflow) {
+        qWarning() << "CTY token too long, not indexed:" << QByteArray(begin, int(end - begin));
+        return;
+    }
+
+    const int tokenDetail = overridden ? overrideDetail(detail, zonesOnly) : baseDetail;
+    if (isCall) {
+        insertExactCall(call, length, tokenDetail);
+    } else {
+        insertPrefix(call, length, tokenDetail);
+    }
+}
+
+int Country::byteSlot(char c)
+{
+    return alphabetSlot(uchar(c));
+}
+
+int Country::internEntity(const QString &name, int dxcc, const Detail &detail)
+{
+    auto it = m_entityIndex.constFind(name);
+    if (it != m_entityIndex.constEnd()) {
+        // A repeated entity takes the latest header, as later entries win.
+        const int entity = it.value();
+        if (dxcc != 0) {
+            m_entityCodes[entity] = dxcc;
         }
-        if (!best.isEmpty()) {
-            return prefixMap.value(best);
+        Detail &existing = m_details[m_entityDetails.at(entity)];
+        existing = detail;
+        existing.entity = entity;
+        return entity;
+    }
+
+    const int entity = m_entityNames.size();
+    m_entityNames.append(name);
+    m_entityCodes.append(dxcc);
+    m_entityIndex.insert(name, entity);
+    m_entityDetails.append(m_details.size());
+    m_details.append(detail);
+    m_details.last().entity = entity;
+    return entity;
+}
+
+int Country::overrideDetail(const Detail &detail, bool zonesOnly)
+{
+    // Zone-only overrides such as (5) or [8] repeat thousands of times; share them.
+    quint64 key = 0;
+    if (zonesOnly) {
+        key = (quint64(quint32(detail.entity)) << 32)
+              | (quint64(quint16(detail.cqZone)) << 16)
+              | quint64(quint16(detail.ituZone));
+        auto it = m_zoneOverrides.constFind(key);
+        if (it != m_zoneOverrides.constEnd()) {
+            return it.value();
         }
-        return QString();
-    };
+    }
 
-    auto normalizeName = [](QString name) -> QString {
-        const QString up = name.trimmed().toUpper();
-        if (up == "UNITED STATES") return "UNITED STATES OF AMERICA";
-        if (up == "FED. REP. OF GERMANY") return "FEDERAL REPUBLIC OF GERMANY";
-        if (up == "VIETNAM") return "VIET NAM";
-        if (up == "SOUTH AFRICA") return "REPUBLIC OF SOUTH AFRICA";
-        if (up == "ST. BARTHELEMY") return "SAINT BARTHELEMY";
-        if (up == "SEYCHELLES") return "SEYCHELLES ISLANDS";
-        if (up == "ST. VINCENT") return "SAINT VINCENT";
-        if (up == "ST. MARTIN") return "SAINT MARTIN";
-        if (up == "ST. LUCIA") return "SAINT LUCIA";
-        if (up == "ST. HELENA") return "SAINT HELENA";
-        if (up == "ST. KITTS & NEVIS") return "SAINT KITTS & NEVIS";
-        if (up == "MAURITIUS") return "MAURITIUS ISLAND";
-        if (up == "FIJI") return "FIJI ISLANDS";
-        if (up == "ASIATIC TURKEY") return "TURKEY";
-        if (up == "SOV MIL ORDER OF MALTA") return "SOVEREIGN MILITARY ORDER OF MALTA";
-        if (up == "BRUNEI DARUSSALAM") return "BRUNEI";
-        if (up == "BOUVET") return "BOUVET ISLAND";
-
-        return name;
+    const int index = m_details.size();
+    m_details.append(detail);
+    if (zonesOnly) {
+        m_zoneOverrides.insert(key, index);
+    }
+    return index;
+}
+
+void Country::insertPrefix(const char *prefix, int length, int detail)
+{
+    for (int i = 0; i < length; ++i) {
+        if (byteSlot(prefix[i]) < 0) {
+            qWarning() << "CTY prefix outside callsign alphabet, not indexed:" << QByteArray(prefix, length);
+            return;
+        }
+    }
+
+    if (m_prefixNodes.isEmpty()) {
+        m_prefixNodes.append(PrefixNode());
+    }
+
+    int node = 0;
+    for (int i = 0; i < length; ++i) {
+        const int slot = byteSlot(prefix[i]);
+        int next = m_prefixNodes.at(node).children[slot];
+        if (next < 0) {
+            next = m_prefixNodes.size();
+            m_prefixNodes.append(PrefixNode());
+            m_prefixNodes[node].children[slot] = next;
+        }
+        node = next;
+    }
+    // Later entries win within a layer; a lower layer never replaces a higher one.
+    PrefixNode &target = m_prefixNodes[node];
+    if (target.detail < 0 || m_layer >= target.layer) {
+        target.detail = detail;
+        target.layer = m_layer;
+    }
+}
+
+void Country::insertExactCall(const char *call, int length, int detail)
+{
+    if (length > kMaxExactCallLength) {
+        qWarning() << "CTY exact call too long, not indexed:" << QByteArray(call, length);
+        return;
+    }
+    ExactCall exact;
+    std::memset(exact.call, 0, sizeof(exact.call));
+    std::memcpy(exact.call, call, size_t(length));
+    exact.detail = detail;
+    exact.layer = m_layer;
+    m_exactCalls.append(exact);
+}
+
+void Country::compile()
+{
+    auto callLess = [](const ExactCall &a, const ExactCall &b) {
+        return std::memcmp(a.call, b.call, sizeof(a.call)) < 0;
     };
+    std::stable_sort(m_exactCalls.begin(), m_exactCalls.end(), [&callLess](const ExactCall &a, const ExactCall &b) {
+        return callLess(a, b) || (!callLess(b, a) && a.layer < b.layer);
+    });
+
+    // Keep the last definition of each call in the highest layer; an empty
+    // entity name never resolves.
+    QVector<ExactCall> calls;
+    calls.reserve(m_exactCalls.size());
+    for (int i = 0; i < m_exactCalls.size(); ++i) {
+        const ExactCall &call = m_exactCalls.at(i);
+        if (i + 1 < m_exactCalls.size() && !callLess(call, m_exactCalls.at(i + 1))) {
+            continue;
+        }
+        calls.append(call);
+    }
+    m_exactCalls = calls;
+    calls.erase(std::remove_if(calls.begin(), calls.end(), [this](const ExactCall &call) {
+                    return m_entityNames.at(m_details.at(call.detail).entity).isEmpty();
+                }), calls.end());
+
+    QString strings;
+    QVector<ImageEntity> entities;
+    entities.reserve(m_entityNames.size());
+    for (int i = 0; i < m_entityNames.size(); ++i) {
+        // Entities known by ADIF code display under their canonical DXCC name.
+        const QString &name = m_entityNames.at(i);
+        const DxccEntity *dxcc = dxccEntity(m_entityCodes.at(i));
+        const QString display = dxcc ? QString::fromLatin1(dxcc->name) : name;
+        ImageEntity entity;
+        entity.dxcc = m_entityCodes.at(i);
+        entity.nameOffset = quint32(strings.size());
+        entity.nameLength = quint32(name.size());
+        strings.append(name);
+        entity.displayOffset = quint32(strings.size());
+        entity.displayLength = quint32(display.size());
+        strings.append(display);
+        entities.append(entity);
+    }
+
+    ImageHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kImageMagic, sizeof(header.magic));
+    header.version = kImageVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.entityCount = quint32(entities.size());
+    header.entitiesOffset = alignOffset(sizeof(ImageHeader));
+    header.detailCount = quint32(m_details.size());
+    header.detailsOffset = alignOffset(header.entitiesOffset + quint64(entities.size()) * sizeof(ImageEntity));
+    header.callCount = quint32(calls.size());
+    header.callsOffset = alignOffset(header.detailsOffset + quint64(m_details.size()) * sizeof(Detail));
+    header.nodeCount = quint32(m_prefixNodes.size());
+    header.nodesOffset = alignOffset(header.callsOffset + quint64(calls.size()) * sizeof(ExactCall));
+    header.stringsLength = quint32(strings.size());
+    header.stringsOffset = alignOffset(header.nodesOffset + quint64(m_prefixNodes.size()) * sizeof(PrefixNode));
+    header.totalSize = quint32(header.stringsOffset + quint64(strings.size()) * sizeof(char16_t));
+
+    QByteArray image(int(header.totalSize), '\0');
+    char *out = image.data();
+    std::memcpy(out, &header, sizeof(header));
+    if (!entities.isEmpty()) {
+        std::memcpy(out + header.entitiesOffset, entities.constData(), entities.size() * sizeof(ImageEntity));
+    }
+    if (!m_details.isEmpty()) {
+        std::memcpy(out + header.detailsOffset, m_details.constData(), m_details.size() * sizeof(Detail));
+    }
+    if (!calls.isEmpty()) {
+        std::memcpy(out + header.callsOffset, calls.constData(), calls.size() * sizeof(ExactCall));
+    }
+    if (!m_prefixNodes.isEmpty()) {
+        std::memcpy(out + header.nodesOffset, m_prefixNodes.constData(), m_prefixNodes.size() * sizeof(PrefixNode));
+    }
+    if (!strings.isEmpty()) {
+        std::memcpy(out + header.stringsOffset, strings.utf16(), strings.size() * sizeof(char16_t));
+    }
+
+    m_image = image;
+    m_snapshotFile.reset();
+    m_cache->clear();
+    if (!attachImage(m_image.constData(), m_image.size())) {
+        qWarning() << "Failed to compile cty.dat index";
+    }
+}
+
+bool Country::attachImage(const char *data, qint64 size)
+{
+    if (size < qint64(sizeof(ImageHeader))) {
+        return false;
+    }
+    ImageHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kImageMagic, sizeof(header.magic)) != 0
+        || header.version != kImageVersion
+        || header.byteOrderMark != kByteOrderMark
+        || header.totalSize != quint64(size)) {
+        return false;
+    }
+    if (!sectionFits(header.entitiesOffset, header.entityCount, sizeof(ImageEntity), size)
+        || !sectionFits(header.detailsOffset, header.detailCount, sizeof(Detail), size)
+        || !sectionFits(header.callsOffset, header.callCount, sizeof(ExactCall), size)
+        || !sectionFits(header.nodesOffset, header.nodeCount, sizeof(PrefixNode), size)
+        || !sectionFits(header.stringsOffset, header.stringsLength, sizeof(char16_t), size)) {
+        return false;
+    }
 
-    QString result = resolve(key);
-    if (!result.isEmpty()) {
-        const QString normalized = normalizeName(result);
-        if (continent) {
-            const QString cont = countryContinent.value(normalized.toUpper(), countryContinent.value(result.toUpper()));
-            if (!cont.isEmpty()) {
-                *continent = cont;
+    const auto *entities = reinterpret_cast<const ImageEntity *>(data + header.entitiesOffset);
+    const auto *details = reinterpret_cast<const Detail *>(data + header.detailsOffset);
+    const auto *calls = reinterpret_cast<const ExactCall *>(data + header.callsOffset);
+    const auto *nodes = reinterpret_cast<const PrefixNode *>(data + header.nodesOffset);
+    const auto *strings = reinterpret_cast<const QChar *>(data + header.stringsOffset);
+
+    // Validate every index once so lookups never have to.
+    const qint64 entityCount = header.entityCount;
+    const qint64 detailCount = header.detailCount;
+    const qint64 nodeCount = header.nodeCount;
+    for (quint32 i = 0; i < header.detailCount; ++i) {
+        if (details[i].entity < 0 || details[i].entity >= entityCount) {
+            return false;
+        }
+    }
+    for (quint32 i = 0; i < header.callCount; ++i) {
+        if (calls[i].detail < 0 || calls[i].detail >= detailCount
+            || calls[i].layer < 0 || calls[i].layer >= LayerCount) {
+            return false;
+        }
+    }
+    for (quint32 i = 0; i < header.nodeCount; ++i) {
+        if (nodes[i].detail < -1 || nodes[i].detail >= detailCount
+            || nodes[i].layer < 0 || nodes[i].layer >= LayerCount) {
+            return false;
+        }
+        for (const qint32 child : nodes[i].children) {
+            if (child < -1 || child >= nodeCount) {
+                return false;
             }
         }
-        return normalized;
     }
 
-    const QStringList parts = key.split('/', Qt::SkipEmptyParts);
-    for (const QString &part : parts) {
-        result = resolve(part);
-        if (!result.isEmpty()) {
-            const QString normalized = normalizeName(result);
-            if (continent) {
-                const QString cont = countryContinent.value(normalized.toUpper(), countryContinent.value(result.toUpper()));
-                if (!cont.isEmpty()) {
-                    *continent = cont;
-                }
+    QVector<QString> displayNames;
+    displayNames.reserve(int(entityCount));
+    QVector<qint32> dxccCodes;
+    dxccCodes.reserve(int(entityCount));
+    for (quint32 i = 0; i < header.entityCount; ++i) {
+        const ImageEntity &entity = entities[i];
+        if (quint64(entity.displayOffset) + entity.displayLength > header.stringsLength) {
+            return false;
+        }
+        displayNames.append(QString(strings + entity.displayOffset, int(entity.displayLength)));
+        dxccCodes.append(entity.dxcc);
+    }
+
+    m_nodes = nodes;
+    m_nodeCount = qint32(header.nodeCount);
+    m_calls = calls;
+    m_callCount = qint32(header.callCount);
+    m_imageDetails = details;
+    m_detailCount = qint32(header.detailCount);
+    m_displayNames = displayNames;
+    m_dxccCodes = dxccCodes;
+    return true;
+}
+
+const Country::ExactCall *Country::exactCall(QLatin1String key) const
+{
+    if (m_callCount == 0 || key.size() == 0 || key.size() > kMaxExactCallLength) {
+        return nullptr;
+    }
+
+    ExactCall needle;
+    std::memset(needle.call, 0, sizeof(needle.call));
+    std::memcpy(needle.call, key.data(), size_t(key.size()));
+
+    const ExactCall *end = m_calls + m_callCount;
+    const ExactCall *it = std::lower_bound(m_calls, end, needle, [](const ExactCall &a, const ExactCall &b) {
+        return std::memcmp(a.call, b.call, sizeof(a.call)) < 0;
+    });
+    if (it == end || std::memcmp(it->call, needle.call, sizeof(needle.call)) != 0) {
+        return nullptr;
+    }
+    return it;
+}
+
+const Country::PrefixNode *Country::longestPrefix(QLatin1String key, int *length) const
+{
+    if (m_nodeCount == 0) {
+        return nullptr;
+    }
+
+    int node = 0;
+    const PrefixNode *best = nullptr;
+    for (int i = 0; i < key.size(); ++i) {
+        const int slot = byteSlot(key.at(i).toLatin1());
+        if (slot < 0) {
+            break;
+        }
+        node = m_nodes[node].children[slot];
+        if (node < 0) {
+            break;
+        }
+        if (m_nodes[node].detail >= 0) {
+            best = &m_nodes[node];
+            *length = i + 1;
+        }
+    }
+    return best;
+}
+
+int Country::resolveDetail(const QString &call, Resolution *resolution) const
+{
+    const Callsign parsed(call);
+    if (!parsed.isValid()) {
+        return -1;
+    }
+
+    // Exact entries win, including ones listed with a suffix such as =N2NL/MM.
+    QLatin1String key = parsed.call();
+    const ExactCall *exact = exactCall(key);
+    if (!exact && parsed.prefix().size() == 0 && parsed.base().size() != parsed.call().size()) {
+        key = parsed.base();
+        exact = exactCall(key);
+    }
+
+    int detail = -1;
+    int length = 0;
+    if (exact) {
+        detail = exact->detail;
+        length = key.size();
+    } else if (!parsed.isOffshore()) {
+        const PrefixNode *node = nullptr;
+        if (parsed.prefix().size() > 0) {
+            key = parsed.prefix();
+            node = longestPrefix(key, &length);
+        }
+        if (!node && parsed.area()) {
+            key = parsed.areaBase();
+            node = longestPrefix(key, &length);
+        }
+        if (!node) {
+            key = parsed.base();
+            node = longestPrefix(key, &length);
+        }
+        if (node) {
+            detail = node->detail;
+            if (resolution) {
+                resolution->layer = Layer(node->layer);
             }
-            return normalized;
         }
     }
-    return QString();
+    if (detail < 0 || m_displayNames.at(m_imageDetails[detail].entity).isEmpty()) {
+        return -1;
+    }
+    if (resolution) {
+        if (exact) {
+            resolution->layer = Layer(exact->layer);
+        }
+        resolution->exactCall = exact != nullptr;
+        resolution->match = QLatin1String(key.data(), length);
+    }
+    return detail;
+}
+
+Country::Resolution Country::explain(const QString &call) const
+{
+    Resolution resolution;
+    resolution.info = detailInfo(resolveDetail(call, &resolution));
+    if (!resolution.info.isValid()) {
+        resolution = Resolution();
+    }
+    return resolution;
+}
+
+CallInfo Country::lookup(const QString &call) const
+{
+    // Keyed as lookupBatch() does, so case variants share one cache slot.
+    const QString key = call.toUpper();
+    int index = -1;
+    if (!m_cache->find(key, &index)) {
+        index = resolveDetail(key);
+        m_cache->insert(key, index);
+    }
+    return detailInfo(index);
+}
+
+void Country::lookupBatch(const QString *calls, int count, CallInfo *out) const
+{
+    // Map every input to its index among the distinct uppercased calls.
+    QVector<QString> unique;
+    QVector<int> uniqueIndex(count);
+    QHash<QString, int> seen;
+    seen.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString key = calls[i].toUpper();
+        auto it = seen.constFind(key);
+        if (it == seen.constEnd()) {
+            it = seen.insert(key, unique.size());
+            unique.append(key);
+        }
+        uniqueIndex[i] = it.value();
+    }
+
+    QVector<int> details(unique.size(), -1);
+    auto resolveRange = [this, &unique, &details](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            details[i] = resolveDetail(unique.at(i));
+        }
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int total = unique.size();
+    const int chunks = std::min(pool->maxThreadCount() + 1, total / kBatchChunkSize);
+    if (chunks <= 1) {
+        resolveRange(0, total);
+    } else {
+        // Chunks are claimed by whoever is free, the calling thread included,
+        // so a busy pool only slows the batch down and never blocks it. Tasks
+        // that start after the last chunk was claimed touch only the state.
+        struct BatchState {
+            std::atomic<int> next{0};
+            QSemaphore done;
+        };
+        auto state = std::make_shared<BatchState>();
+        const int chunkSize = (total + chunks - 1) / chunks;
+        auto work = [state, &resolveRange, chunks, chunkSize, total] {
+            int chunk;
+            while ((chunk = state->next++) < chunks) {
+                resolveRange(chunk * chunkSize, std::min(total, (chunk + 1) * chunkSize));
+                state->done.release();
+            }
+        };
+        for (int i = 1; i < chunks; ++i) {
+            pool->start(work);
+        }
+        work();
+        state->done.acquire(chunks);
+    }
+
+    QVector<CallInfo> infos(unique.size());
+    for (int i = 0; i < unique.size(); ++i) {
+        infos[i] = detailInfo(details.at(i));
+    }
+    for (int i = 0; i < count; ++i) {
+        out[i] = infos.at(uniqueIndex.at(i));
+    }
+}
+
+QVector<CallInfo> Country::lookupBatch(const QVector<QString> &calls) const
+{
+    QVector<CallInfo> infos(calls.size());
+    lookupBatch(calls.constData(), calls.size(), infos.data());
+    return infos;
+}
+
+CallInfo Country::detailInfo(int index) const
+{
+    CallInfo info;
+    if (index < 0) {
+        return info;
+    }
+
+    const Detail &detail = m_imageDetails[index];
+    info.entity = detail.entity;
+    info.dxcc = m_dxccCodes.at(detail.entity);
+    info.name = m_displayNames.at(detail.entity);
+    info.continent = continentName(detail.continent);
+    info.cqZone = detail.cqZone;
+    info.ituZone = detail.ituZone;
+    info.latitude = detail.latitude;
+    info.longitude = detail.longitude;
+    info.utcOffset = detail.utcOffset;
+    return info;
+}
+
+QString Country::GetCountry(const QString &call, QString *continent) const
+{
+    const CallInfo info = lookup(call);
+    if (!info.isValid()) {
+        return QString();
+    }
+    if (continent && !info.continent.isEmpty()) {
+        *continent = info.continent;
+    }
+    return info.name;
 }
@@ -3,19 +3,189 @@
 
 #include <QString>
 #include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <array>
+#include <memory>
+
+#include "callcache.h"
+
+class QFile;
+
+struct CallInfo
+{
+    int entity = -1;
+    int dxcc = 0;            // ADIF DXCC entity code, 0 when unknown
+    QString name;
+    QString continent;
+    int cqZone = 0;
+    int ituZone = 0;
+    double latitude = 0.0;   // degrees, north positive
+    double longitude = 0.0;  // degrees, west positive as in cty.dat
+    double utcOffset = 0.0;  // hours
+
+    bool isValid() const { return entity >= 0; }
+};
 
 class Country
 {
 public:
+    // Prefix sources in ascending precedence; a later layer wins for the same
+    // prefix or exact call. All layers compile into one index, so lookups cost
+    // the same however many are loaded.
+    enum Layer : qint32 {
+        CtyLayer,           // AD1C cty.dat
+        BigCtyLayer,        // big cty.dat, with many more exact calls
+        OverrideLayer,      // local entries in cty.dat format
+        SpecialEventLayer,  // special-event calls, "call,country" CSV
+        ExceptionLayer,     // exact-call exceptions, "call,country" CSV
+        LayerCount
+    };
+
+    struct Source {
+        Layer layer;
+        QString path;
+    };
+
+    static constexpr const char *kCtyFile = "cty.dat";
+    static constexpr const char *kBigCtyFile = "bigcty.dat";
+    static constexpr const char *kOverrideFile = "cty_override.dat";
+    static constexpr const char *kSpecialEventFile = "wwa_activators_2026.csv";
+    static constexpr const char *kExceptionFile = "cty_exceptions.csv";
+
+    // Which layer, and which prefix or exact call in it, resolved a call.
+    struct Resolution {
+        CallInfo info;
+        Layer layer = CtyLayer;
+        bool exactCall = false;
+        QString match;
+    };
+
     Country() = default;
 
-    void init();
+    // Current process-wide resolver, built from cty.dat on first use. The
+    // returned instance is immutable; lookups are safe from any thread without
+    // locking. Callers hold the pointer for one unit of work and fetch it again
+    // for the next, so a reload never changes tables under a running lookup.
+    static std::shared_ptr<const Country> shared();
+    // Atomically replaces the resolver returned by shared().
+    static void publish(std::shared_ptr<const Country> country);
+
+    static QVector<Source> defaultSources();
+    static QString layerName(Layer layer);
+
+    // Loads the sources, preferring a compiled snapshot whose hash matches all
+    // of them. Only the first source is required; returns false without it.
+    bool init(const QVector<Source> &sources = defaultSources());
     void ParseCty(const QString &content);
+    void ParseCty(const QByteArray &content);
+    // Build-time layering, then compile() once. Precedence follows the layer,
+    // not the order of calls; call lists need their entities added first.
+    void addCty(const QByteArray &content, Layer layer);
+    void addCalls(const QByteArray &csv, Layer layer);
+    void compile();
     QString GetCountry(const QString &call, QString *continent = nullptr) const;
-public:
-    QHash<QString, QString> callMap;
-    QHash<QString, QString> prefixMap;
-    QHash<QString, QString> countryContinent;
+    CallInfo lookup(const QString &call) const;
+    // Diagnostic lookup; bypasses the call cache.
+    Resolution explain(const QString &call) const;
+
+    // Resolves calls[i] into out[i] for a whole log at once. Repeated calls
+    // are resolved once and large batches are split across the global thread
+    // pool. Batches bypass the call cache so they do not evict live spots.
+    void lookupBatch(const QString *calls, int count, CallInfo *out) const;
+    QVector<CallInfo> lookupBatch(const QVector<QString> &calls) const;
+
+    // Resolutions are cached per callsign; the cache is dropped on every reload.
+    CallCache::Stats cacheStats() const { return m_cache->stats(); }
+
+    int entityCount() const { return m_displayNames.size(); }
+    int exactCallCount() const { return m_callCount; }
+    // SHA-1 of the sources passed to init(); empty when parsed directly.
+    QByteArray sourceHash() const { return m_sourceHash; }
+
+    // Number of entities added, removed, or with different prefixes, calls or
+    // zone data between two resolvers.
+    static int changedEntities(const Country &before, const Country &after);
+
+    // Snapshots are written to a temporary file and renamed into place.
+    // Each source hash has its own file, so a reload never has to replace
+    // the one the published resolver has mapped, which Windows refuses.
+    bool saveSnapshot(const QString &path, const QByteArray &ctyHash) const;
+    bool loadSnapshot(const QString &path, const QByteArray &ctyHash);
+    static QString snapshotPath(const QByteArray &ctyHash);
+    // Deletes the other snapshots in current's directory, where possible.
+    static void removeStaleSnapshots(const QString &current);
+
+private:
+    // Callsign alphabet: 0-9, A-Z and '/'.
+    static constexpr int kPrefixSlots = 37;
+    static constexpr int kMaxExactCallLength = 16;
+
+    // Zone and location data for an entity, or for a prefix or call that
+    // overrides it with (cq), [itu], <lat/lon>, {continent} or ~utc~.
+    struct Detail {
+        qint32 entity;
+        qint16 cqZone;
+        qint16 ituZone;
+        float latitude;
+        float longitude;
+        float utcOffset;
+        char continent[4];
+    };
+
+    struct PrefixNode {
+        std::array<qint32, kPrefixSlots> children;
+        qint32 detail = -1;
+        qint32 layer = CtyLayer;
+
+        PrefixNode() { children.fill(-1); }
+    };
+
+    struct ExactCall {
+        char call[kMaxExactCallLength];
+        qint32 detail;
+        qint32 layer;
+    };
+
+    static int byteSlot(char c);
+    int internEntity(const QString &name, int dxcc, const Detail &detail);
+    int overrideDetail(const Detail &detail, bool zonesOnly);
+    void addToken(const char *begin, const char *end, int baseDetail);
+    void insertPrefix(const char *prefix, int length, int detail);
+    void insertExactCall(const char *call, int length, int detail);
+    int entityForName(const QString &name) const;
+    bool attachImage(const char *data, qint64 size);
+    const ExactCall *exactCall(QLatin1String key) const;
+    const PrefixNode *longestPrefix(QLatin1String key, int *length) const;
+    int resolveDetail(const QString &key, Resolution *resolution = nullptr) const;
+    CallInfo detailInfo(int index) const;
+    QHash<QString, quint64> entityFingerprints() const;
+
+    // Build state filled by addCty and addCalls; node 0 is the trie root.
+    Layer m_layer = CtyLayer;
+    QVector<PrefixNode> m_prefixNodes;
+    QVector<ExactCall> m_exactCalls;
+    QVector<Detail> m_details;
+    QVector<QString> m_entityNames;
+    QVector<qint32> m_entityCodes;
+    QVector<qint32> m_entityDetails;
+    QHash<QString, int> m_entityIndex;
+    QHash<quint64, int> m_zoneOverrides;
+
+    // Compiled image, either built in memory or memory-mapped from a snapshot.
+    QByteArray m_image;
+    std::shared_ptr<QFile> m_snapshotFile;
+    const PrefixNode *m_nodes = nullptr;
+    qint32 m_nodeCount = 0;
+    const ExactCall *m_calls = nullptr;
+    qint32 m_callCount = 0;
+    const Detail *m_imageDetails = nullptr;
+    qint32 m_detailCount = 0;
+    QVector<QString> m_displayNames;
+    QVector<qint32> m_dxccCodes;
+    QByteArray m_sourceHash;
+
+    std::unique_ptr<CallCache> m_cache = std::make_unique<CallCache>();
 };
 
 #endif // COUNTRY_H
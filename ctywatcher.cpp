@@ -0,0 +1,134 @@
+#include "ctywatcher.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
+
+#include <memory>
+
+namespace {
+
+// Editors and downloaders write in several steps; wait for the file to settle.
+constexpr int kReloadDelayMs = 1000;
+
+struct ReloadResult {
+    bool published = false;
+    int changedEntities = 0;
+    qint64 elapsedMs = 0;
+};
+
+}
+
+CtyWatcher::CtyWatcher(const QVector<Country::Source> &sources, QObject *parent)
+    : QObject(parent)
+    , m_sources(sources)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(kReloadDelayMs);
+    connect(&m_debounce, &QTimer::timeout, this, &CtyWatcher::reload);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &CtyWatcher::scheduleReload);
+    // Files replaced by rename drop out of the watch list; the directory
+    // notices them coming back, and also a layer file created later.
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &CtyWatcher::scheduleReload);
+    m_stamps = stamps();
+    watchFiles();
+}
+
+void CtyWatcher::watchFiles()
+{
+    QStringList paths;
+    for (const Country::Source &source : m_sources) {
+        if (source.path.isEmpty()) {
+            continue;
+        }
+        const QFileInfo info(source.path);
+        if (info.exists()) {
+            paths.append(info.absoluteFilePath());
+        }
+        paths.append(info.absolutePath());
+    }
+    paths.removeDuplicates();
+
+    const QStringList watched = m_watcher.files() + m_watcher.directories();
+    for (const QString &path : paths) {
+        if (!watched.contains(path)) {
+            m_watcher.addPath(path);
+        }
+    }
+}
+
+void CtyWatcher::scheduleReload()
+{
+    watchFiles();
+    // A watched directory also changes for unrelated files, such as the
+    // database and its journal when started from the app directory.
+    const QVector<Stamp> current = stamps();
+    if (current == m_stamps) {
+        return;
+    }
+    m_stamps = current;
+    m_debounce.start();
+}
+
+QVector<CtyWatcher::Stamp> CtyWatcher::stamps() const
+{
+    QVector<Stamp> result;
+    result.reserve(m_sources.size());
+    for (const Country::Source &source : m_sources) {
+        Stamp stamp;
+        const QFileInfo info(source.path);
+        if (!source.path.isEmpty() && info.exists()) {
+            stamp.size = info.size();
+            stamp.modified = info.lastModified();
+        }
+        result.append(stamp);
+    }
+    return result;
+}
+
+void CtyWatcher::reload()
+{
+    if (m_reloading) {
+        m_reloadAgain = true;
+        return;
+    }
+    m_reloading = true;
+
+    const QVector<Country::Source> sources = m_sources;
+    auto result = std::make_shared<ReloadResult>();
+    QThread *thread = QThread::create([sources, result] {
+        QElapsedTimer timer;
+        timer.start();
+
+        auto next = std::make_shared<Country>();
+        if (!next->init(sources) || next->entityCount() == 0) {
+            qWarning() << "cty.dat reload failed, keeping the current resolver";
+            return;
+        }
+        const std::shared_ptr<const Country> current = Country::shared();
+        if (current && current->sourceHash() == next->sourceHash()) {
+            return;
+        }
+
+        result->changedEntities = current ? Country::changedEntities(*current, *next) : next->entityCount();
+        Country::publish(std::move(next));
+        result->published = true;
+        result->elapsedMs = timer.elapsed();
+    });
+
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    connect(thread, &QThread::finished, this, [this, result]() {
+        m_reloading = false;
+        if (result->published) {
+            qDebug() << "cty.dat reloaded in" << result->elapsedMs << "ms,"
+                     << result->changedEntities << "entities changed";
+            emit reloaded(result->changedEntities, result->elapsedMs);
+        }
+        if (m_reloadAgain) {
+            m_reloadAgain = false;
+            reload();
+        }
+    });
+    thread->start(QThread::LowPriority);
+}
@@ -0,0 +1,48 @@
+#ifndef CTYWATCHER_H
+#define CTYWATCHER_H
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include "country.h"
+
+// Rebuilds the shared cty.dat resolver in the background when any of its
+// source layers changes, then publishes it with Country::publish(). Spot
+// ingestion keeps resolving against the previous instance until the swap.
+class CtyWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CtyWatcher(const QVector<Country::Source> &sources = Country::defaultSources(),
+                        QObject *parent = nullptr);
+
+    // Rebuilds now instead of waiting for a file change.
+    void reload();
+
+signals:
+    void reloaded(int changedEntities, qint64 elapsedMs);
+
+private:
+    // Size and modification time of a source; size -1 when it is missing.
+    struct Stamp {
+        qint64 size = -1;
+        QDateTime modified;
+        bool operator==(const Stamp &other) const { return size == other.size && modified == other.modified; }
+    };
+
+    void watchFiles();
+    void scheduleReload();
+    QVector<Stamp> stamps() const;
+
+    QVector<Country::Source> m_sources;
+    QVector<Stamp> m_stamps;    // as of the last scheduled reload
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+    bool m_reloading = false;
+    bool m_reloadAgain = false;
+};
+
+#endif // CTYWATCHER_H
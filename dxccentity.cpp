@@ -0,0 +1,389 @@
+#include "dxccentity.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace {
+
+const DxccEntity kEntities[] = {
+    {1, "VE", "VE",         "CANADA"},
+    {3, "YA", "YA",         "AFGHANISTAN"},
+    {4, "3B6", "3B7",       "AGALEGA & SAINT BRANDON ISLANDS"},
+    {5, "OH0", "OH0",       "ALAND ISLANDS"},
+    {6, "KL", "KL7",        "ALASKA"},
+    {7, "ZA", "ZA",         "ALBANIA"},
+    {9, "KH8", "KH8",       "AMERICAN SAMOA"},
+    {10, "FT/z", "FT5Z",    "AMSTERDAM & SAINT PAUL ISLANDS"},
+    {11, "VU4", "VU4",      "ANDAMAN & NICOBAR ISLANDS"},
+    {12, "VP2E", "VP2E",    "ANGUILLA"},
+    {13, "CE9", "CE9, KC4", "ANTARCTICA"},
+    {14, "EK", "EK",        "ARMENIA"},
+    {15, "UA9", "UA9,UA0",  "ASIATIC RUSSIA"},
+    {16, "ZL9", "ZL9",      "NEW ZEALAND SUBANTARCTIC ISLANDS"},
+    {17, "YV0", "YV0",      "AVES ISLAND"},
+    {18, "4J", "4J",        "AZERBAIJAN"},
+    {20, "KH1", "KH1",      "BAKER & HOWLAND ISLANDS"},
+    {21, "EA6", "EA6",      "BALEARIC ISLANDS"},
+    {22, "T8", "T8",        "PALAU"},
+    {24, "3Y/b", "3Y",      "BOUVET ISLAND"},
+    {27, "EU", "EU",        "BELARUS"},
+    {29, "EA8", "EA8",      "CANARY ISLANDS"},
+    {31, "T31", "T31",      "CENTRAL KIRIBATI"},
+    {32, "EA9", "EA9",      "CEUTA & MELILLA"},
+    {33, "VQ9", "VQ9",      "CHAGOS ISLANDS"},
+    {34, "ZL7", "ZL7",      "CHATHAM ISLAND"},
+    {35, "VK9X", "VK9X",    "CHRISTMAS ISLAND"},
+    {36, "FO/c", "FO0",     "CLIPPERTON ISLAND"},
+    {37, "TI9", "TI9",      "COCOS ISLAND"},
+    {38, "VK9C", "VK9C",    "COCOS (KEELING) ISLANDS"},
+    {40, "SV9", "SV9",      "CRETE"},
+    {41, "FT/w", "FT5W",    "CROZET ISLAND"},
+    {43, "KP5", "KP5",      "DESECHEO ISLAND"},
+    {45, "SV5", "SV5",      "DODECANESE"},
+    {46, "9M6", "9M6",      "EAST MALAYSIA"},
+    {47, "CE0Y", "CE0Y",    "EASTER ISLAND"},
+    {48, "T32", "T32",      "EASTERN KIRIBATI"},
+    {49, "3C", "3C",        "EQUATORIAL GUINEA"},
+    {50, "XE", "XE",        "MEXICO"},
+    {51, "E3", "E3",        "ERITREA"},
+    {52, "ES", "ES",        "ESTONIA"},
+    {53, "ET", "ET",        "ETHIOPIA"},
+    {54, "UA", "UA",        "EUROPEAN RUSSIA"},
+    {56, "PY0F", "PY0F",    "FERNANDO DE NORONHA"},
+    {60, "C6", "C6A",       "BAHAMAS"},
+    {61, "R1FJ", "R1F",     "FRANZ JOSEF LAND"},
+    {62, "8P", "8P",        "BARBADOS"},
+    {63, "FY", "FY",        "FRENCH GUIANA"},
+    {64, "VP9", "VP9",      "BERMUDA"},
+    {65, "VP2V", "VP2V",    "BRITISH VIRGIN ISLANDS"},
+    {66, "V3", "V3",        "BELIZE"},
+    {69, "ZF", "ZF",        "CAYMAN ISLANDS"},
+    {70, "CM", "CO",        "CUBA"},
+    {71, "HC8", "HC8",      "GALAPAGOS ISLANDS"},
+    {72, "HI", "HI",        "DOMINICAN REPUBLIC"},
+    {74, "YS", "YS",        "EL SALVADOR"},
+    {75, "4L", "4L",        "GEORGIA"},
+    {76, "TG", "TG",        "GUATEMALA"},
+    {77, "J3", "J3",        "GRENADA"},
+    {78, "HH", "HH",        "HAITI"},
+    {79, "FG", "FG",        "GUADELOUPE"},
+    {80, "HR", "HR",        "HONDURAS"},
+    {82, "6Y", "6Y",        "JAMAICA"},
+    {84, "FM", "FM",        "MARTINIQUE"},
+    {86, "YN", "YN",        "NICARAGUA"},
+    {88, "HP", "HP",        "PANAMA"},
+    {89, "VP5", "VP5",      "TURKS & CAICOS ISLANDS"},
+    {90, "9Y", "9Y",        "TRINIDAD & TOBAGO"},
+    {91, "P4", "P4",        "ARUBA"},
+    {94, "V2", "V2",        "ANTIGUA & BARBUDA"},
+    {95, "J7", "J7",        "DOMINICA"},
+    {96, "VP2M", "VP2M",    "MONTSERRAT"},
+    {97, "J6", "J6",        "SAINT LUCIA"},
+    {98, "J8", "J8",        "SAINT VINCENT"},
+    {99, "FT/g", "FR/G",    "GLORIOSO ISLAND"},
+    {100, "LU", "LU",       "ARGENTINA"},
+    {103, "KH2", "KH2",     "GUAM"},
+    {104, "CP", "CP",       "BOLIVIA"},
+    {105, "KG4", "KG4",     "GUANTANAMO BAY"},
+    {106, "GU", "GU",       "GUERNSEY"},
+    {107, "3X", "3XA",      "GUINEA"},
+    {108, "PY", "PY",       "BRAZIL"},
+    {109, "J5", "J5",       "GUINEA-BISSAU"},
+    {110, "KH6", "KH6,KH7", "HAWAII"},
+    {111, "VK0H", "VK0",    "HEARD ISLAND"},
+    {112, "CE", "CE",       "CHILE"},
+    {114, "GD", "GD",       "ISLE OF MAN"},
+    {116, "HK", "HK",       "COLOMBIA"},
+    {117, "4U1I", "4U1ITU", "ITU HQ"},
+    {118, "JX", "JX",       "JAN MAYEN"},
+    {120, "HC", "HC",       "ECUADOR"},
+    {122, "GJ", "GJ",       "JERSEY"},
+    {123, "KH3", "KH3",     "JOHNSTON ISLAND"},
+    {124, "FT/j", "FR/J",   "JUAN DE NOVA, EUROPA"},
+    {125, "CE0Z", "CE0Z",   "JUAN FERNANDEZ ISLAND"},
+    {126, "UA2", "UA2",     "KALININGRAD"},
+    {129, "8R", "8R",       "GUYANA"},
+    {130, "UN", "UN",       "KAZAKHSTAN"},
+    {131, "FT/x", "FT5X",   "KERGUELEN ISLAND"},
+    {132, "ZP", "ZP",       "PARAGUAY"},
+    {133, "ZL8", "ZL8",     "KERMADEC ISLAND"},
+    {135, "EX", "EX",       "KYRGYZSTAN"},
+    {136, "OA", "OA",       "PERU"},
+    {137, "HL", "HL,DS",    "REPUBLIC OF KOREA"},
+    {138, "KH7K", "KH7K",   "KURE ISLAND"},
+    {140, "PZ", "PZ",       "SURINAME"},
+    {141, "VP8", "VP8",     "FALKLAND ISLANDS"},
+    {142, "VU7", "VU7",     "LAKSHADWEEP ISLANDS"},
+    {143, "XW", "XW",       "LAOS"},
+    {144, "CX", "CX",       "URUGUAY"},
+    {145, "YL", "YL",       "LATVIA"},
+    {146, "LY", "LY",       "LITHUANIA"},
+    {147, "VK9L", "VK9L",   "LORD HOWE ISLAND"},
+    {148, "YV", "YV",       "VENEZUELA"},
+    {149, "CU", "CU",       "AZORES"},
+    {150, "VK", "VK",       "AUSTRALIA"},
+    {152, "XX9", "XX9",     "MACAO"},
+    {153, "VK0M", "VK0",    "MACQUARIE ISLAND"},
+    {157, "C2", "C21",      "NAURU"},
+    {158, "YJ", "YJ",       "VANUATU"},
+    {159, "8Q", "8Q",       "MALDIVES"},
+    {160, "A3", "A3",       "TONGA"},
+    {161, "HK0/m", "HK0",   "MALPELO ISLAND"},
+    {162, "FK", "FK",       "NEW CALEDONIA"},
+    {163, "P2", "P2",       "PAPUA NEW GUINEA"},
+    {165, "3B8", "3B8",     "MAURITIUS ISLAND"},
+    {166, "KH0", "KH0",     "MARIANA ISLANDS"},
+    {167, "OJ0", "OH0M",    "MARKET REEF"},
+    {168, "V7", "V7",       "MARSHALL ISLANDS"},
+    {169, "FH", "FH",       "MAYOTTE ISLAND"},
+    {170, "ZL", "ZL",       "NEW ZEALAND"},
+    {171, "VK9M", "VK9M",   "MELLISH REEF"},
+    {172, "VP6", "VP6",     "PITCAIRN ISLAND"},
+    {173, "V6", "V6",       "MICRONESIA"},
+    {174, "KH4", "KH4",     "MIDWAY ISLAND"},
+    {175, "FO", "FO",       "FRENCH POLYNESIA"},
+    {176, "3D2", "3D2",     "FIJI ISLANDS"},
+    {177, "JD/m", "JD1",    "MINAMI TORISHIMA"},
+    {179, "ER", "ER",       "MOLDOVA"},
+    {180, "SV/a", "SV/A",   "MOUNT ATHOS"},
+    {181, "C9", "C9",       "MOZAMBIQUE"},
+    {182, "KP1", "KP1",     "NAVASSA ISLAND"},
+    {185, "H4", "H4",       "SOLOMON ISLANDS"},
+    {187, "5U", "5U",       "NIGER"},
+    {188, "E6", "E6",       "NIUE"},
+    {189, "VK9N", "VK9N",   "NORFOLK ISLAND"},
+    {190, "5W", "5W",       "SAMOA"},
+    {191, "E5/n", "E5",     "NORTH COOK ISLANDS"},
+    {192, "JD/o", "JD1",    "OGASAWARA"},
+    {195, "3C0", "3C0",     "ANNOBON"},
+    {197, "KH5", "KH5",     "PALMYRA & JARVIS ISLANDS"},
+    {199, "3Y/p", "3Y",     "PETER 1 ISLAND"},
+    {201, "ZS8", "ZS8",     "PRINCE EDWARD & MARION ISLANDS"},
+    {202, "KP4", "KP3,KP4", "PUERTO RICO"},
+    {203, "C3", "C31",      "ANDORRA"},
+    {204, "XF4", "XF4",     "REVILLAGIGEDO"},
+    {205, "ZD8", "ZD8",     "ASCENSION ISLAND"},
+    {206, "OE", "OE",       "AUSTRIA"},
+    {207, "3B9", "3B9",     "RODRIGUEZ ISLAND"},
+    {209, "ON", "ON",       "BELGIUM"},
+    {211, "CY0", "CY0",     "SABLE ISLAND"},
+    {212, "LZ", "LZ",       "BULGARIA"},
+    {213, "FS", "FS",       "SAINT MARTIN"},
+    {214, "TK", "TK",       "CORSICA"},
+    {215, "5B", "5B",       "CYPRUS"},
+    {216, "HK0/a", "HK0",   "SAN ANDRES ISLAND"},
+    {217, "CE0X", "CE0X",   "SAN FELIX ISLAND"},
+    {219, "S9", "S9",       "SAO TOME & PRINCIPE"},
+    {221, "OZ", "OZ",       "DENMARK"},
+    {222, "OY", "OY",       "FAROE ISLANDS"},
+    {223, "G", "G,M",       "ENGLAND"},
+    {224, "OH", "OH",       "FINLAND"},
+    {225, "IS", "IS0,IMO",  "SARDINIA"},
+    {227, "F", "F",         "FRANCE"},
+    {230, "DL", "DL",       "FEDERAL REPUBLIC OF GERMANY"},
+    {232, "T5", "T5",       "SOMALIA"},
+    {233, "ZB", "ZB2",      "GIBRALTAR"},
+    {234, "E5/s", "E5",     "SOUTH COOK ISLANDS"},
+    {235, "VP8/g", "VP8",   "SOUTH GEORGIA ISLAND"},
+    {236, "SV", "SV",       "GREECE"},
+    {237, "OX", "OX",       "GREENLAND"},
+    {238, "VP8/o", "VP8",   "SOUTH ORKNEY ISLANDS"},
+    {239, "HA", "HA",       "HUNGARY"},
+    {240, "VP8/s", "VP8",   "SOUTH SANDWICH ISLANDS"},
+    {241, "VP8/h", "VP8",   "SOUTH SHETLAND ISLANDS"},
+    {242, "TF", "TF",       "ICELAND"},
+    {245, "EI", "EI",       "IRELAND"},
+    {246, "1A", "1A0KM",    "SOVEREIGN MILITARY ORDER OF MALTA"},
+    {247, "1S", "1S",       "SPRATLY ISLANDS"},
+    {248, "I", "I",         "ITALY"},
+    {249, "V4", "V4",       "SAINT KITTS & NEVIS"},
+    {250, "ZD7", "ZD7",     "SAINT HELENA"},
+    {251, "HB0", "HB0",     "LIECHTENSTEIN"},
+    {252, "CY9", "CY9",     "SAINT PAUL ISLAND"},
+    {253, "PY0S", "PY0S",   "SAINT PETER AND PAUL ROCKS"},
+    {254, "LX", "LX",       "LUXEMBOURG"},
+    {256, "CT3", "CT3",     "MADEIRA ISLANDS"},
+    {257, "9H", "9H",       "MALTA"},
+    {259, "JW", "JW",       "SVALBARD"},
+    {260, "3A", "3A",       "MONACO"},
+    {262, "EY", "EY",       "TAJIKISTAN"},
+    {263, "PA", "PA",       "NETHERLANDS"},
+    {265, "GI", "GI,MI",    "NORTHERN IRELAND"},
+    {266, "LA", "LA",       "NORWAY"},
+    {269, "SP", "SP",       "POLAND"},
+    {270, "ZK3", "ZK3",     "TOKELAU ISLANDS"},
+    {272, "CT", "CT",       "PORTUGAL"},
+    {273, "PY0T", "PY0T",   "TRINDADE & MARTIM VAZ ISLANDS"},
+    {274, "ZD9", "ZD9",     "TRISTAN DA CUNHA & GOUGH ISLANDS"},
+    {275, "YO", "YO",       "ROMANIA"},
+    {276, "FT/t", "FR/T",   "TROMELIN ISLAND"},
+    {277, "FP", "FP",       "SAINT PIERRE & MIQUELON"},
+    {278, "T7", "T7",       "SAN MARINO"},
+    {279, "GM", "GM,MM",    "SCOTLAND"},
+    {280, "EZ", "EZ",       "TURKMENISTAN"},
+    {281, "EA", "EA",       "SPAIN"},
+    {282, "T2", "T2",       "TUVALU"},
+    {283, "ZC4", "ZC4",     "U K BASES ON CYPRUS"},
+    {284, "SM", "SM",       "SWEDEN"},
+    {285, "KP2", "KP2",     "US VIRGIN ISLANDS"},
+    {286, "5X", "5X",       "UGANDA"},
+    {287, "HB", "HB",       "SWITZERLAND"},
+    {288, "UR", "UT",       "UKRAINE"},
+    {289, "4U1U", "4U1UN",  "UNITED NATIONS HQ"},
+    {291, "K", "K, W",      "UNITED STATES OF AMERICA"},
+    {292, "UK", "UJ",       "UZBEKISTAN"},
+    {293, "3W", "3W, XV",   "VIET NAM"},
+    {294, "GW", "GW,MW",    "WALES"},
+    {295, "HV", "HV",       "VATICAN CITY"},
+    {296, "YU", "YU",       "SERBIA"},
+    {297, "KH9", "KH9",     "WAKE ISLAND"},
+    {298, "FW", "FW",       "WALLIS & FUTUNA ISLANDS"},
+    {299, "9M2", "9M2",     "WEST MALAYSIA"},
+    {301, "T30", "T30",     "WESTERN KIRIBATI"},
+    {302, "S0", "S0",       "WESTERN SAHARA"},
+    {303, "VK9W", "VK9W",   "WILLIS ISLAND"},
+    {304, "A9", "A9",       "BAHRAIN"},
+    {305, "S2", "S2",       "BANGLADESH"},
+    {306, "A5", "A5",       "BHUTAN"},
+    {308, "TI", "TI",       "COSTA RICA"},
+    {309, "XZ", "XZ",       "MYANMAR"},
+    {312, "XU", "XU",       "CAMBODIA"},
+    {315, "4S", "4S",       "SRI LANKA"},
+    {318, "BY", "BY",       "CHINA"},
+    {321, "VR", "VR",       "HONG KONG"},
+    {324, "VU", "VU",       "INDIA"},
+    {327, "YB", "YB",       "INDONESIA"},
+    {330, "EP", "EP",       "IRAN"},
+    {333, "YI", "YI",       "IRAQ"},
+    {336, "4X", "4X",       "ISRAEL"},
+    {339, "JA", "JA",       "JAPAN"},
+    {342, "JY", "JY",       "JORDAN"},
+    {344, "P5", "P5,HM",    "DPRK (NORTH KOREA)"},
+    {345, "V8", "V8",       "BRUNEI"},
+    {348, "9K", "9K",       "KUWAIT"},
+    {354, "OD", "OD",       "LEBANON"},
+    {363, "JT", "JT",       "MONGOLIA"},
+    {369, "9N", "9N",       "NEPAL"},
+    {370, "A4", "A4",       "OMAN"},
+    {372, "AP", "AP",       "PAKISTAN"},
+    {375, "DU", "DU",       "PHILIPPINES"},
+    {376, "A7", "A7",       "QATAR"},
+    {378, "HZ", "HZ",       "SAUDI ARABIA"},
+    {379, "S7", "S7",       "SEYCHELLES ISLANDS"},
+    {381, "9V", "9V",       "SINGAPORE"},
+    {382, "J2", "J2",       "DJIBOUTI"},
+    {384, "YK", "YK",       "SYRIA"},
+    {386, "BV", "BV",       "TAIWAN"},
+    {387, "HS", "HS",       "THAILAND"},
+    {390, "TA", "TA",       "TURKEY"},
+    {391, "A6", "A6",       "UNITED ARAB EMIRATES"},
+    {400, "7X", "7X",       "ALGERIA"},
+    {401, "D2", "D2",       "ANGOLA"},
+    {402, "A2", "A2",       "BOTSWANA"},
+    {404, "9U", "9U",       "BURUNDI"},
+    {406, "TJ", "TJ",       "CAMEROON"},
+    {408, "TL", "TL",       "CENTRAL AFRICAN REPUBLIC"},
+    {409, "D4", "D4",       "CAPE VERDE"},
+    {410, "TT", "TT",       "CHAD"},
+    {411, "D6", "D6",       "COMOROS"},
+    {412, "TN", "TN",       "REPUBLIC OF THE CONGO"},
+    {414, "9Q", "9Q",       "DEMOCRATIC REPUBLIC OF THE CONGO"},
+    {416, "TY", "TY",       "BENIN"},
+    {420, "TR", "TR",       "GABON"},
+    {422, "C5", "C5",       "THE GAMBIA"},
+    {424, "9G", "9G",       "GHANA"},
+    {428, "TU", "TU",       "COTE D'IVOIRE"},
+    {430, "5Z", "5Z",       "KENYA"},
+    {432, "7P", "7P",       "LESOTHO"},
+    {434, "EL", "EL",       "LIBERIA"},
+    {436, "5A", "5A",       "LIBYA"},
+    {438, "5R", "5R",       "MADAGASCAR"},
+    {440, "7Q", "7Q",       "MALAWI"},
+    {442, "TZ", "TZ",       "MALI"},
+    {444, "5T", "5T",       "MAURITANIA"},
+    {446, "CN", "CN",       "MOROCCO"},
+    {450, "5N", "5N",       "NIGERIA"},
+    {452, "Z2", "Z2",       "ZIMBABWE"},
+    {453, "FR", "FR",       "REUNION ISLAND"},
+    {454, "9X", "9X",       "RWANDA"},
+    {456, "6W", "6W",       "SENEGAL"},
+    {458, "9L", "9L",       "SIERRA LEONE"},
+    {460, "3D2/r", "3D2",   "ROTUMA"},
+    {462, "ZS", "ZS",       "REPUBLIC OF SOUTH AFRICA"},
+    {464, "V5", "V5",       "NAMIBIA"},
+    {466, "ST", "ST",       "SUDAN"},
+    {468, "3DA", "3DA",     "KINGDOM OF ESWATINI"},
+    {470, "5H", "5H",       "TANZANIA"},
+    {474, "3V", "3V",       "TUNISIA"},
+    {478, "SU", "SU",       "EGYPT"},
+    {480, "XT", "XT",       "BURKINA FASO"},
+    {482, "9J", "9J",       "ZAMBIA"},
+    {483, "5V", "5V7",      "TOGO"},
+    {489, "3D2/c", "3D2",   "CONWAY REEF"},
+    {490, "T33", "T33",     "BANABA ISLAND"},
+    {492, "7O", "7O",       "YEMEN"},
+    {497, "9A", "9A",       "CROATIA"},
+    {499, "S5", "S5",       "SLOVENIA"},
+    {501, "E7", "E7",       "BOSNIA-HERZEGOVINA"},
+    {502, "Z3", "Z3",       "NORTH MACEDONIA"},
+    {503, "OK", "OK,OL",    "CZECH REPUBLIC"},
+    {504, "OM", "OM",       "SLOVAK REPUBLIC"},
+    {505, "BV9P", "BV9P",   "PRATAS ISLAND"},
+    {506, "BS7", "BS7H",    "SCARBOROUGH REEF"},
+    {507, "H40", "H40",     "TEMOTU PROVINCE"},
+    {508, "FO/a", "FO",     "AUSTRAL ISLANDS"},
+    {509, "FO/m", "FO",     "MARQUESAS ISLANDS"},
+    {510, "E4", "E4",       "PALESTINE"},
+    {511, "4W", "4W",       "TIMOR - LESTE"},
+    {512, "FK/c", "FK/C",   "CHESTERFIELD ISLANDS"},
+    {513, "VP6/d", "VP6",   "DUCIE ISLAND"},
+    {514, "4O", "4O",       "MONTENEGRO"},
+    {515, "KH8/s", "KH8",   "SWAINS ISLAND"},
+    {516, "FJ", "FJ",       "SAINT BARTHELEMY"},
+    {517, "PJ2", "PJ2",     "CURACAO"},
+    {518, "PJ7", "PJ7",     "SINT MAARTEN"},
+    {519, "PJ5", "PJ5,PJ6", "SABA & SAINT EUSTATIUS"},
+    {520, "PJ4", "PJ4",     "BONAIRE"},
+    {521, "Z8", "Z8",       "REPUBLIC OF SOUTH SUDAN"},
+    {522, "Z6", "Z6",       "REPUBLIC OF KOSOVO"},
+};
+
+}
+
+const QVector<DxccEntity> &dxccEntities()
+{
+    static const QVector<DxccEntity> entities(std::begin(kEntities), std::end(kEntities));
+    return entities;
+}
+
+const DxccEntity *dxccEntity(int code)
+{
+    auto it = std::lower_bound(std::begin(kEntities), std::end(kEntities), code,
+                               [](const DxccEntity &entity, int value) { return entity.code < value; });
+    return it != std::end(kEntities) && it->code == code ? it : nullptr;
+}
+
+const DxccEntity *dxccEntityForCtyPrefix(const QByteArray &prefix)
+{
+    static const QHash<QByteArray, const DxccEntity *> index = [] {
+        QHash<QByteArray, const DxccEntity *> byPrefix;
+        for (const DxccEntity &entity : kEntities) {
+            byPrefix.insert(QByteArray(entity.ctyPrefix).toUpper(), &entity);
+        }
+        return byPrefix;
+    }();
+    return index.value(prefix.trimmed().toUpper(), nullptr);
+}
+
+const DxccEntity *dxccEntityForName(const QString &name)
+{
+    static const QHash<QString, const DxccEntity *> index = [] {
+        QHash<QString, const DxccEntity *> byName;
+        for (const DxccEntity &entity : kEntities) {
+            byName.insert(QString::fromLatin1(entity.name), &entity);
+        }
+        return byName;
+    }();
+    return index.value(name.trimmed().toUpper(), nullptr);
+}
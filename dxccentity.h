@@ -0,0 +1,26 @@
+#ifndef DXCCENTITY_H
+#define DXCCENTITY_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// A current DXCC entity. Entities are identified everywhere by their ADIF
+// DXCC code; 0 means no entity (e.g. maritime mobile).
+struct DxccEntity
+{
+    int code;
+    const char *ctyPrefix; // primary prefix on the cty.dat header line
+    const char *prefix;    // prefix shown in the dxcc table
+    const char *name;
+};
+
+// Current DXCC entities ordered by code.
+const QVector<DxccEntity> &dxccEntities();
+
+// Return nullptr when there is no such entity.
+const DxccEntity *dxccEntity(int code);
+const DxccEntity *dxccEntityForCtyPrefix(const QByteArray &prefix);
+const DxccEntity *dxccEntityForName(const QString &name);
+
+#endif // DXCCENTITY_H
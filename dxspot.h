@@ -0,0 +1,35 @@
+#ifndef DXSPOT_H
+#define DXSPOT_H
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+#include "bandplan.h"
+#include "continent.h"
+#include "spotmode.h"
+
+// A needed cluster spot, parsed and resolved on the feed thread.
+struct DxSpot
+{
+    QString time;
+    QString call;
+    QString freq;
+    QString mode;
+    QString country;
+    int dxcc = 0;
+    QString spotter;    // spotter continent
+    QString message;
+    qint64 epoch = 0;   // UTC seconds when received
+    qint64 id = 0;      // spots table rowid, 0 until SpotWriter numbers it
+
+    // Typed forms of freq, mode and spotter, for filtering.
+    qint64 hz = 0;
+    Band band = Band::None;
+    SpotMode modeGroup = SpotMode::Unknown;
+    Continent continent = Continent::None;
+};
+
+Q_DECLARE_METATYPE(DxSpot)
+
+#endif // DXSPOT_H
@@ -0,0 +1,98 @@
+#include "lineframer.h"
+
+#include <QDebug>
+#include <QIODevice>
+
+#include <cstring>
+
+void LineFramer::append(const char *data, qsizetype size)
+{
+    if (size <= 0) {
+        return;
+    }
+    compact();
+    m_buffer.append(data, size);
+    dropOverlongLine();
+}
+
+qint64 LineFramer::readFrom(QIODevice *device)
+{
+    const qint64 available = device->bytesAvailable();
+    if (available <= 0) {
+        return 0;
+    }
+    compact();
+    // Read straight into the buffer's tail instead of through a temporary.
+    const qsizetype oldSize = m_buffer.size();
+    m_buffer.resize(oldSize + available);
+    const qint64 read = device->read(m_buffer.data() + oldSize, available);
+    m_buffer.resize(oldSize + qMax<qint64>(read, 0));
+    dropOverlongLine();
+    return qMax<qint64>(read, 0);
+}
+
+bool LineFramer::next(QByteArrayView *line)
+{
+    const char *data = m_buffer.constData();
+    const qsizetype size = m_buffer.size();
+    // Resume the scan where the last one stopped; a partial line is never
+    // searched twice however many reads it takes to arrive.
+    const qsizetype from = qMax(m_begin, m_scanned);
+    const void *newline = from < size ? std::memchr(data + from, '\n', size_t(size - from)) : nullptr;
+    if (!newline) {
+        m_scanned = size;
+        return false;
+    }
+
+    qsizetype begin = m_begin;
+    qsizetype end = static_cast<const char *>(newline) - data;
+    m_begin = end + 1;
+    m_scanned = m_begin;
+    // Accept \r\n, \n and the \n\r some cluster nodes send.
+    if (begin < end && data[begin] == '\r') {
+        ++begin;
+    }
+    if (end > begin && data[end - 1] == '\r') {
+        --end;
+    }
+    *line = QByteArrayView(data + begin, end - begin);
+    return true;
+}
+
+void LineFramer::clear()
+{
+    m_buffer.clear();
+    m_begin = 0;
+    m_scanned = 0;
+}
+
+void LineFramer::compact()
+{
+    if (m_begin == 0) {
+        return;
+    }
+    // Keeps the allocation; only the partial line, if any, moves.
+    const qsizetype remaining = m_buffer.size() - m_begin;
+    if (remaining > 0) {
+        std::memmove(m_buffer.data(), m_buffer.constData() + m_begin, size_t(remaining));
+    }
+    m_buffer.resize(remaining);
+    m_scanned -= m_begin;
+    m_begin = 0;
+}
+
+void LineFramer::dropOverlongLine()
+{
+    if (pending() <= kMaxLineLength) {
+        return;
+    }
+    const qsizetype from = qMax(m_begin, m_scanned);
+    const char *data = m_buffer.constData();
+    const qsizetype size = m_buffer.size();
+    const void *newline = from < size ? std::memchr(data + from, '\n', size_t(size - from)) : nullptr;
+    if (newline) {
+        return;
+    }
+    qWarning() << "Dropping" << pending() << "bytes without a line break";
+    clear();
+}
@@ -0,0 +1,41 @@
+#ifndef LINEFRAMER_H
+#define LINEFRAMER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+class QIODevice;
+
+// Splits a byte stream into lines. Received bytes go into one reusable
+// buffer; next() hands out views of complete lines without their line
+// terminator and keeps a trailing partial line for the next read. Views stay
+// valid until the next append(), readFrom() or clear().
+class LineFramer
+{
+public:
+    // A line longer than this without a newline is dropped, so a peer that
+    // never sends one cannot grow the buffer without bound.
+    static constexpr int kMaxLineLength = 4096;
+
+    void append(const char *data, qsizetype size);
+    void append(QByteArrayView data) { append(data.data(), data.size()); }
+    // Appends everything the device has buffered; returns the bytes read.
+    qint64 readFrom(QIODevice *device);
+
+    bool next(QByteArrayView *line);
+    // Bytes received but not yet returned as a line.
+    qsizetype pending() const { return m_buffer.size() - m_begin; }
+    // The unterminated tail, such as a login prompt waiting for input.
+    QByteArrayView partial() const { return QByteArrayView(m_buffer).sliced(m_begin); }
+    void clear();
+
+private:
+    void compact();
+    void dropOverlongLine();
+
+    QByteArray m_buffer;
+    qsizetype m_begin = 0;
+    qsizetype m_scanned = 0;
+};
+
+#endif // LINEFRAMER_H
@@ -1,15 +1,22 @@
 #include "mainwindow.h"
+#include "bandplan.h"
+#include "continent.h"
+#include "dxccentity.h"
+#include "spotmode.h"
 
 #include <QApplication>
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDir>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
-#include <QSet>
-#include <QRegularExpression>
+#include <QHash>
 #include <QVariantMap>
 
+#include <algorithm>
+#include <cstring>
+
 const QStringList calls = {
     "3B8WWA",
     "6D2WWA",
@@ -132,379 +139,72 @@ bool setupWwaTable(QSqlDatabase db)
     return true;
 }
 
-static QMap<QString, QString> dxccPrefixMap()
+static bool hasColumn(QSqlDatabase db, const QString &table, const QString &column)
 {
-    static const QString raw = R"RAW(
-    ?=SPRATLY ISLANDS
-    1A0KM=SOVEREIGN MILITARY ORDER OF MALTA
-    3A=MONACO
-    3B7=AGALEGA & SAINT BRANDON ISLANDS
-    3B8=MAURITIUS ISLAND
-    3B9=RODRIGUEZ ISLAND
-    3C=EQUATORIAL GUINEA
-    3C0=ANNOBON
-    3D2=CONWAY REEF
-    3D2=FIJI ISLANDS
-    3D2=ROTUMA
-    3DA=KINGDOM OF ESWATINI
-    3V=TUNISIA
-    3W, XV=VIET NAM
-    3XA=GUINEA
-    3Y=BOUVET ISLAND
-    3Y=PETER 1 ISLAND
-    4J=AZERBAIJAN
-    4L=GEORGIA
-    4O=MONTENEGRO
-    4S=SRI LANKA
-    4U1ITU=ITU HQ
-    4U1UN=UNITED NATIONS HQ
-    4W=TIMOR - LESTE
-    4X=ISRAEL
-    5A=LIBYA
-    5B=CYPRUS
-    5H=TANZANIA
-    5N=NIGERIA
-    5R=MADAGASCAR
-    5T=MAURITANIA
-    5U=NIGER
-    5V7=TOGO
-    5W=SAMOA
-    5X=UGANDA
-    5Z=KENYA
-    6W=SENEGAL
-    6Y=JAMAICA
-    7O=YEMEN
-    7P=LESOTHO
-    7Q=MALAWI
-    7X=ALGERIA
-    8P=BARBADOS
-    8Q=MALDIVES
-    8R=GUYANA
-    9A=CROATIA
-    9G=GHANA
-    9H=MALTA
-    9J=ZAMBIA
-    9K=KUWAIT
-    9L=SIERRA LEONE
-    9M2=WEST MALAYSIA
-    9M6=EAST MALAYSIA
-    9N=NEPAL
-    9Q=DEMOCRATIC REPUBLIC OF THE CONGO
-    9U=BURUNDI
-    9V=SINGAPORE
-    9X=RWANDA
-    9Y=TRINIDAD & TOBAGO
-    A2=BOTSWANA
-    A3=TONGA
-    A4=OMAN
-    A5=BHUTAN
-    A6=UNITED ARAB EMIRATES
-    A7=QATAR
-    A9=BAHRAIN
-    AP=PAKISTAN
-    BS7H=SCARBOROUGH REEF
-    BV=TAIWAN
-    BV9P=PRATAS ISLAND
-    BY=CHINA
-    C21=NAURU
-    C31=ANDORRA
-    C5=THE GAMBIA
-    C6A=BAHAMAS
-    C9=MOZAMBIQUE
-    CE=CHILE
-    CE0X=SAN FELIX ISLAND
-    CE0Y=EASTER ISLAND
-    CE0Z=JUAN FERNANDEZ ISLAND
-    CE9, KC4=ANTARCTICA
-    CN=MOROCCO
-    CO=CUBA
-    CP=BOLIVIA
-    CT=PORTUGAL
-    CT3=MADEIRA ISLANDS
-    CU=AZORES
-    CX=URUGUAY
-    CY0=SABLE ISLAND
-    CY9=SAINT PAUL ISLAND
-    D2=ANGOLA
-    D4=CAPE VERDE
-    D6=COMOROS
-    DL=FEDERAL REPUBLIC OF GERMANY
-    DU=PHILIPPINES
-    E3=ERITREA
-    E4=PALESTINE
-    E5=NORTH COOK ISLANDS
-    E5=SOUTH COOK ISLANDS
-    E6=NIUE
-    E7=BOSNIA-HERZEGOVINA
-    EA=SPAIN
-    EA6=BALEARIC ISLANDS
-    EA8=CANARY ISLANDS
-    EA9=CEUTA & MELILLA
-    EI=IRELAND
-    EK=ARMENIA
-    EL=LIBERIA
-    EP=IRAN
-    ER=MOLDOVA
-    ES=ESTONIA
-    ET=ETHIOPIA
-    EU=BELARUS
-    EX=KYRGYZSTAN
-    EY=TAJIKISTAN
-    EZ=TURKMENISTAN
-    F=FRANCE
-    FG=GUADELOUPE
-    FH=MAYOTTE ISLAND
-    FJ=SAINT BARTHELEMY
-    FK=NEW CALEDONIA
-    FK/C=CHESTERFIELD ISLANDS
-    FM=MARTINIQUE
-    FO=AUSTRAL ISLANDS
-    FO=FRENCH POLYNESIA
-    FO=MARQUESAS ISLANDS
-    FO0=CLIPPERTON ISLAND
-    FP=SAINT PIERRE & MIQUELON
-    FR=REUNION ISLAND
-    FR/G=GLORIOSO ISLAND
-    FR/J=JUAN DE NOVA, EUROPA
-    FR/T=TROMELIN ISLAND
-    FS=SAINT MARTIN
-    FT5W=CROZET ISLAND
-    FT5X=KERGUELEN ISLAND
-    FT5Z=AMSTERDAM & SAINT PAUL ISLANDS
-    FW=WALLIS & FUTUNA ISLANDS
-    FY=FRENCH GUIANA
-    G,M=ENGLAND
-    GD=ISLE OF MAN
-    GI,MI=NORTHERN IRELAND
-    GJ=JERSEY
-    GM,MM=SCOTLAND
-    GU=GUERNSEY
-    GW,MW=WALES
-    H4=SOLOMON ISLANDS
-    H40=TEMOTU PROVINCE
-    HA=HUNGARY
-    HB=SWITZERLAND
-    HB0=LIECHTENSTEIN
-    HC=ECUADOR
-    HC8=GALAPAGOS ISLANDS
-    HH=HAITI
-    HI=DOMINICAN REPUBLIC
-    HK=COLOMBIA
-    HK0=MALPELO ISLAND
-    HK0=SAN ANDRES ISLAND
-    HL,DS=REPUBLIC OF KOREA
-    HP=PANAMA
-    HR=HONDURAS
-    HS=THAILAND
-    HV=VATICAN CITY
-    HZ=SAUDI ARABIA
-    I=ITALY
-    IS0,IMO=SARDINIA
-    J2=DJIBOUTI
-    J3=GRENADA
-    J5=GUINEA-BISSAU
-    J6=SAINT LUCIA
-    J7=DOMINICA
-    J8=SAINT VINCENT
-    JA=JAPAN
-    JD1=MINAMI TORISHIMA
-    JD1=OGASAWARA
-    JT=MONGOLIA
-    JW=SVALBARD
-    JX=JAN MAYEN
-    JY=JORDAN
-    K, W=UNITED STATES OF AMERICA
-    KG4=GUANTANAMO BAY
-    KH0=MARIANA ISLANDS
-    KH1=BAKER & HOWLAND ISLANDS
-    KH2=GUAM
-    KH3=JOHNSTON ISLAND
-    KH4=MIDWAY ISLAND
-    KH5=PALMYRA & JARVIS ISLANDS
-    KH6,KH7=HAWAII
-    KH7K=KURE ISLAND
-    KH8=AMERICAN SAMOA
-    KH8=SWAINS ISLAND
-    KH9=WAKE ISLAND
-    KL7=ALASKA
-    KP1=NAVASSA ISLAND
-    KP2=US VIRGIN ISLANDS
-    KP3,KP4=PUERTO RICO
-    KP5=DESECHEO ISLAND
-    LA=NORWAY
-    LU=ARGENTINA
-    LX=LUXEMBOURG
-    LY=LITHUANIA
-    LZ=BULGARIA
-    OA=PERU
-    OD=LEBANON
-    OE=AUSTRIA
-    OH=FINLAND
-    OH0=ALAND ISLANDS
-    OH0M=MARKET REEF
-    OK,OL=CZECH REPUBLIC
-    OM=SLOVAK REPUBLIC
-    ON=BELGIUM
-    OX=GREENLAND
-    OY=FAROE ISLANDS
-    OZ=DENMARK
-    P2=PAPUA NEW GUINEA
-    P4=ARUBA
-    P5,HM=DPRK (NORTH KOREA)
-    PA=NETHERLANDS
-    PJ2=CURACAO
-    PJ4=BONAIRE
-    PJ5,PJ6=SABA & SAINT EUSTATIUS
-    PJ7=SINT MAARTEN
-    PY=BRAZIL
-    PY0F=FERNANDO DE NORONHA
-    PY0S=SAINT PETER AND PAUL ROCKS
-    PY0T=TRINDADE & MARTIM VAZ ISLANDS
-    PZ=SURINAME
-    R1F=FRANZ JOSEF LAND
-    S0=WESTERN SAHARA
-    S2=BANGLADESH
-    S5=SLOVENIA
-    S7=SEYCHELLES ISLANDS
-    S9=SAO TOME & PRINCIPE
-    SM=SWEDEN
-    SP=POLAND
-    ST=SUDAN
-    SU=EGYPT
-    SV=GREECE
-    SV/A=MOUNT ATHOS
-    SV5=DODECANESE
-    SV9=CRETE
-    T2=TUVALU
-    T30=WESTERN KIRIBATI
-    T31=CENTRAL KIRIBATI
-    T32=EASTERN KIRIBATI
-    T33=BANABA ISLAND
-    T5=SOMALIA
-    T7=SAN MARINO
-    T8=PALAU
-    TA=TURKEY
-    TF=ICELAND
-    TG=GUATEMALA
-    TI=COSTA RICA
-    TI9=COCOS ISLAND
-    TJ=CAMEROON
-    TK=CORSICA
-    TL=CENTRAL AFRICAN REPUBLIC
-    TN=REPUBLIC OF THE CONGO
-    TR=GABON
-    TT=CHAD
-    TU=COTE D'IVOIRE
-    TY=BENIN
-    TZ=MALI
-    UA=EUROPEAN RUSSIA
-    UA2=KALININGRAD
-    UA9,UA0=ASIATIC RUSSIA
-    UJ=UZBEKISTAN
-    UN=KAZAKHSTAN
-    UT=UKRAINE
-    V2=ANTIGUA & BARBUDA
-    V3=BELIZE
-    V4=SAINT KITTS & NEVIS
-    V5=NAMIBIA
-    V6=MICRONESIA
-    V7=MARSHALL ISLANDS
-    V8=BRUNEI
-    VE=CANADA
-    VK=AUSTRALIA
-    VK0=HEARD ISLAND
-    VK0=MACQUARIE ISLAND
-    VK9C=COCOS (KEELING) ISLANDS
-    VK9L=LORD HOWE ISLAND
-    VK9M=MELLISH REEF
-    VK9N=NORFOLK ISLAND
-    VK9W=WILLIS ISLAND
-    VK9X=CHRISTMAS ISLAND
-    VP2E=ANGUILLA
-    VP2M=MONTSERRAT
-    VP2V=BRITISH VIRGIN ISLANDS
-    VP5=TURKS & CAICOS ISLANDS
-    VP6=DUCIE ISLAND
-    VP6=PITCAIRN ISLAND
-    VP8=FALKLAND ISLANDS
-    VP8=SOUTH GEORGIA ISLAND
-    VP8=SOUTH ORKNEY ISLANDS
-    VP8=SOUTH SANDWICH ISLANDS
-    VP8=SOUTH SHETLAND ISLANDS
-    VP9=BERMUDA
-    VQ9=CHAGOS ISLANDS
-    VR=HONG KONG
-    VU=INDIA
-    VU4=ANDAMAN & NICOBAR ISLANDS
-    VU7=LAKSHADWEEP ISLANDS
-    XE=MEXICO
-    XF4=REVILLAGIGEDO
-    XT=BURKINA FASO
-    XU=CAMBODIA
-    XW=LAOS
-    XX9=MACAO
-    XZ=MYANMAR
-    YA=AFGHANISTAN
-    YB=INDONESIA
-    YI=IRAQ
-    YJ=VANUATU
-    YK=SYRIA
-    YL=LATVIA
-    YN=NICARAGUA
-    YO=ROMANIA
-    YS=EL SALVADOR
-    YU=SERBIA
-    YV=VENEZUELA
-    YV0=AVES ISLAND
-    Z2=ZIMBABWE
-    Z3=NORTH MACEDONIA
-    Z6=REPUBLIC OF KOSOVO
-    Z8=REPUBLIC OF SOUTH SUDAN
-    ZA=ALBANIA
-    ZB2=GIBRALTAR
-    ZC4=U K BASES ON CYPRUS
-    ZD7=SAINT HELENA
-    ZD8=ASCENSION ISLAND
-    ZD9=TRISTAN DA CUNHA & GOUGH ISLANDS
-    ZF=CAYMAN ISLANDS
-    ZK3=TOKELAU ISLANDS
-    ZL=NEW ZEALAND
-    ZL7=CHATHAM ISLAND
-    ZL8=KERMADEC ISLAND
-    ZL9=NEW ZEALAND SUBANTARCTIC ISLANDS
-    ZP=PARAGUAY
-    ZS=REPUBLIC OF SOUTH AFRICA
-    ZS8=PRINCE EDWARD & MARION ISLANDS
-    )RAW";
-
-    QMap<QString, QString> map;
-    const QStringList lines = raw.split(QRegularExpression(R"(\r?\n)"), Qt::SkipEmptyParts);
-    for (const QString &line : lines) {
-        const int sep = line.indexOf('=');
-        if (sep <= 0) {
-            continue;
+    QSqlQuery info(db);
+    if (info.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        while (info.next()) {
+            if (info.value(1).toString().compare(column, Qt::CaseInsensitive) == 0) {
+                return true;
+            }
         }
-        QString prefix = line.left(sep).trimmed();
-        QString entity = line.mid(sep + 1).trimmed();
-        if (entity.isEmpty()) {
-            continue;
+    }
+    return false;
+}
+
+// Adds the typed filter columns and fills them once from the text columns.
+static bool migrateSpotsToTypedColumns(QSqlDatabase db)
+{
+    QSqlQuery query(db);
+    for (const char *column : {"hz", "band", "mode_group", "continent"}) {
+        if (!query.exec(QString("ALTER TABLE spots ADD COLUMN %1 INTEGER").arg(column))) {
+            qWarning() << "Failed to add" << column << "column to spots:" << query.lastError();
+            return false;
         }
-        map.insert(entity.toUpper(), prefix);
     }
-    return map;
+
+    db.transaction();
+    QSqlQuery select(db);
+    QSqlQuery update(db);
+    update.prepare("UPDATE spots SET hz = ?, band = ?, mode_group = ?, continent = ? WHERE rowid = ?");
+    int migrated = 0;
+    if (select.exec("SELECT rowid, freq, mode, spotter FROM spots")) {
+        while (select.next()) {
+            const qint64 hz = frequencyHz(select.value(1).toString());
+            update.addBindValue(hz);
+            update.addBindValue(int(bandForHz(hz)));
+            update.addBindValue(int(spotModeForName(select.value(2).toString().trimmed())));
+            update.addBindValue(int(continentForName(select.value(3).toString())));
+            update.addBindValue(select.value(0));
+            if (!update.exec()) {
+                qWarning() << "Failed to migrate spot:" << update.lastError();
+                db.rollback();
+                return false;
+            }
+            ++migrated;
+        }
+    }
+    if (!db.commit()) {
+        qWarning() << "Failed to commit spot migration:" << db.lastError();
+        db.rollback();
+        return false;
+    }
+    qDebug() << "Migrated" << migrated << "spots to typed columns";
+    return true;
 }
 
 static bool normalizeDxccTable(QSqlDatabase db)
 {
-    const QMap<QString, QString> prefixMap = dxccPrefixMap();
     const QStringList valueColumns = {
         "Mix", "Ph", "CW", "RT", "SAT", "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2"
     };
 
-    QVariantMap mergedRows;
+    // Rows are keyed by ADIF DXCC code. Rows written before the code column
+    // existed are matched on their entity name once and carry the code after.
+    QHash<int, QVariantMap> mergedRows;
     QSqlQuery select(db);
     if (!select.exec(R"(
-        SELECT Prefix, Entity, Mix, Ph, CW, RT, SAT, "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2"
+        SELECT dxcc, Entity, Mix, Ph, CW, RT, SAT, "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2"
         FROM dxcc
     )")) {
         qWarning() << "Failed to read DXCC rows:" << select.lastError();
@@ -512,35 +212,21 @@ static bool normalizeDxccTable(QSqlDatabase db)
     }
 
     while (select.next()) {
-        const QString entityKey = select.value(1).toString().trimmed().toUpper();
-        if (!prefixMap.contains(entityKey)) {
+        const DxccEntity *entity = dxccEntity(select.value(0).toInt());
+        if (!entity) {
+            entity = dxccEntityForName(select.value(1).toString());
+        }
+        if (!entity) {
             continue;
         }
 
-        QVariantMap row = mergedRows.value(entityKey).toMap();
-        row.insert("Prefix", prefixMap.value(entityKey));
-        row.insert("Entity", entityKey);
+        QVariantMap &row = mergedRows[entity->code];
         for (int i = 0; i < valueColumns.size(); ++i) {
             const QString value = select.value(i + 2).toString().trimmed();
             if (!value.isEmpty() && row.value(valueColumns.at(i)).toString().trimmed().isEmpty()) {
                 row.insert(valueColumns.at(i), value);
             }
         }
-        mergedRows.insert(entityKey, row);
-    }
-
-    for (auto it = prefixMap.cbegin(); it != prefixMap.cend(); ++it) {
-        if (mergedRows.contains(it.key())) {
-            continue;
-        }
-
-        QVariantMap row;
-        row.insert("Prefix", it.value());
-        row.insert("Entity", it.key());
-        for (const QString &column : valueColumns) {
-            row.insert(column, "");
-        }
-        mergedRows.insert(it.key(), row);
     }
 
     if (!db.transaction()) {
@@ -557,33 +243,37 @@ static bool normalizeDxccTable(QSqlDatabase db)
 
     QSqlQuery insert(db);
     if (!insert.prepare(R"(
-        INSERT INTO dxcc (Prefix, Entity, Mix, Ph, CW, RT, SAT, "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2")
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        INSERT INTO dxcc (dxcc, Prefix, Entity, Mix, Ph, CW, RT, SAT, "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2")
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
     )")) {
         qWarning() << "Failed to prepare normalized DXCC insert:" << insert.lastError();
         db.rollback();
         return false;
     }
 
-    QStringList entities = prefixMap.keys();
-    entities.sort();
-    for (const QString &entity : entities) {
-        const QVariantMap row = mergedRows.value(entity).toMap();
-        insert.addBindValue(row.value("Prefix").toString());
-        insert.addBindValue(row.value("Entity").toString());
+    // Listed alphabetically by name, as shown in the DXCC tab.
+    QVector<DxccEntity> entities = dxccEntities();
+    std::sort(entities.begin(), entities.end(), [](const DxccEntity &a, const DxccEntity &b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+    for (const DxccEntity &entity : entities) {
+        const QVariantMap row = mergedRows.value(entity.code);
+        insert.addBindValue(entity.code);
+        insert.addBindValue(QString::fromLatin1(entity.prefix));
+        insert.addBindValue(QString::fromLatin1(entity.name));
         for (const QString &column : valueColumns) {
             insert.addBindValue(row.value(column).toString());
         }
         if (!insert.exec()) {
-            qWarning() << "Failed to reinsert normalized DXCC row:" << entity << insert.lastError();
+            qWarning() << "Failed to reinsert normalized DXCC row:" << entity.code << insert.lastError();
             db.rollback();
             return false;
         }
         insert.finish();
     }
 
-    if (!query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_dxcc_entity_unique ON dxcc(Entity COLLATE NOCASE)")) {
-        qWarning() << "Failed to create DXCC unique index:" << query.lastError();
+    if (!query.exec("CREATE UNIQUE INDEX IF NOT EXISTS idx_dxcc_code ON dxcc(dxcc)")) {
+        qWarning() << "Failed to create DXCC code index:" << query.lastError();
         db.rollback();
         return false;
     }
@@ -623,7 +313,8 @@ bool setupDxccTable(QSqlDatabase db)
             "12" INTEGER,
             "10" INTEGER,
             "6"  INTEGER,
-            "2"  INTEGER
+            "2"  INTEGER,
+            dxcc INTEGER
         )
     )").arg(tableName);
 
@@ -632,6 +323,13 @@ bool setupDxccTable(QSqlDatabase db)
         return false;
     }
 
+    if (!hasColumn(db, tableName, "dxcc")) {
+        if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN dxcc INTEGER").arg(tableName))) {
+            qWarning() << "Failed to add dxcc column to DXCC table:" << query.lastError();
+            return false;
+        }
+    }
+
     if (!normalizeDxccTable(db)) {
         return false;
     }
@@ -671,26 +369,57 @@ bool setupDatabase()
                 mode TEXT,
                 country TEXT,
                 spotter TEXT,
-                message TEXT
+                message TEXT,
+                dxcc INTEGER,
+                ts INTEGER,
+                hz INTEGER,
+                band INTEGER,
+                mode_group INTEGER,
+                continent INTEGER
             )
         )";
         if (!query.exec(createSpots)) {
             qWarning() << "Failed to create spots table:" << query.lastError();
             return false;
         }
-        QSet<QString> spotCols;
-        QSqlQuery info(db);
-        if (info.exec("PRAGMA table_info(spots)")) {
-            while (info.next()) {
-                spotCols.insert(info.value(1).toString().toLower());
-            }
-        }
-        if (!spotCols.contains("message")) {
+        if (!hasColumn(db, "spots", "message")) {
             if (!query.exec("ALTER TABLE spots ADD COLUMN message TEXT")) {
                 qWarning() << "Failed to add message column to spots:" << query.lastError();
                 return false;
             }
         }
+        if (!hasColumn(db, "spots", "dxcc")) {
+            if (!query.exec("ALTER TABLE spots ADD COLUMN dxcc INTEGER")) {
+                qWarning() << "Failed to add dxcc column to spots:" << query.lastError();
+                return false;
+            }
+        }
+        if (!hasColumn(db, "spots", "ts")) {
+            // Rows from before the column start their retention window now.
+            if (!query.exec("ALTER TABLE spots ADD COLUMN ts INTEGER")) {
+                qWarning() << "Failed to add ts column to spots:" << query.lastError();
+                return false;
+            }
+            query.prepare("UPDATE spots SET ts = ?");
+            query.addBindValue(QDateTime::currentSecsSinceEpoch());
+            if (!query.exec()) {
+                qWarning() << "Failed to set ts of existing spots:" << query.lastError();
+                return false;
+            }
+        }
+        if (!query.exec("CREATE INDEX IF NOT EXISTS spots_ts ON spots (ts)")) {
+            qWarning() << "Failed to create spots ts index:" << query.lastError();
+            return false;
+        }
+        if (!hasColumn(db, "spots", "hz") && !migrateSpotsToTypedColumns(db)) {
+            return false;
+        }
+        // Filters are applied to the rows in memory; an index on their
+        // columns would only slow every insert.
+        if (!query.exec("DROP INDEX IF EXISTS spots_filter")) {
+            qWarning() << "Failed to drop spots filter index:" << query.lastError();
+            return false;
+        }
     }
 
     return true;
@@ -1,7 +1,14 @@
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
 #include "delegate.h"
-#include "tcpreceiver.h"
+#include "bandplan.h"
+#include "callsign.h"
+#include "ctywatcher.h"
+#include "dxccentity.h"
+#include "spotfeeds.h"
+#include "spotfilter.h"
+#include "spottablemodel.h"
+#include "spotwriter.h"
 
 #include <QAction>
 #include <QApplication>
@@ -28,7 +35,7 @@
 #include <array>
 #include <utility>
 #include <QSqlTableModel>
-#include <QTcpSocket>
+#include <QThread>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QMessageBox>
@@ -70,6 +77,47 @@ bool intersectsAnyScreen(const QRect &rect)
     });
 }
 
+constexpr int kSpotExpiryIntervalMs = 60 * 1000;
+constexpr int kSpotExpiryBatch = 5000;
+constexpr int kDefaultSpotRetentionMinutes = 180;
+constexpr int kSpotFilterSaveDelayMs = 1000;
+
+// A spot tab filter checkbox, its settings key and its SpotFilter bit.
+struct SpotFilterCheck
+{
+    QCheckBox *box;
+    const char *key;
+    quint32 bit;
+};
+
+QVector<SpotFilterCheck> spotFilterChecks(Ui::MainWindow *ui)
+{
+    return {
+        {ui->spotBand160CheckBox, "spotFilters/band160", SpotFilter::bandBit(Band::M160)},
+        {ui->spotBand80CheckBox, "spotFilters/band80", SpotFilter::bandBit(Band::M80)},
+        {ui->spotBand40CheckBox, "spotFilters/band40", SpotFilter::bandBit(Band::M40)},
+        {ui->spotBand30CheckBox, "spotFilters/band30", SpotFilter::bandBit(Band::M30)},
+        {ui->spotBand20CheckBox, "spotFilters/band20", SpotFilter::bandBit(Band::M20)},
+        {ui->spotBand17CheckBox, "spotFilters/band17", SpotFilter::bandBit(Band::M17)},
+        {ui->spotBand15CheckBox, "spotFilters/band15", SpotFilter::bandBit(Band::M15)},
+        {ui->spotBand12CheckBox, "spotFilters/band12", SpotFilter::bandBit(Band::M12)},
+        {ui->spotBand10CheckBox, "spotFilters/band10", SpotFilter::bandBit(Band::M10)},
+        {ui->spotBand6CheckBox, "spotFilters/band6", SpotFilter::bandBit(Band::M6)},
+        {ui->spotBand2CheckBox, "spotFilters/band2", SpotFilter::bandBit(Band::M2)},
+        {ui->spotModeCwCheckBox, "spotFilters/modeCW", SpotFilter::modeBit(SpotMode::Cw)},
+        {ui->spotModePhCheckBox, "spotFilters/modePH", SpotFilter::modeBit(SpotMode::Phone)},
+        {ui->spotModeRtCheckBox, "spotFilters/modeRT", SpotFilter::modeBit(SpotMode::Data)},
+        {ui->spotModeSatCheckBox, "spotFilters/modeSAT", SpotFilter::modeBit(SpotMode::Sat)},
+        {ui->spotterAfCheckBox, "spotFilters/spotterAF", SpotFilter::continentBit(Continent::Af)},
+        {ui->spotterAnCheckBox, "spotFilters/spotterAN", SpotFilter::continentBit(Continent::An)},
+        {ui->spotterAsCheckBox, "spotFilters/spotterAS", SpotFilter::continentBit(Continent::As)},
+        {ui->spotterEuCheckBox, "spotFilters/spotterEU", SpotFilter::continentBit(Continent::Eu)},
+        {ui->spotterNaCheckBox, "spotFilters/spotterNA", SpotFilter::continentBit(Continent::Na)},
+        {ui->spotterOcCheckBox, "spotFilters/spotterOC", SpotFilter::continentBit(Continent::Oc)},
+        {ui->spotterSaCheckBox, "spotFilters/spotterSA", SpotFilter::continentBit(Continent::Sa)},
+    };
+}
+
 QPoint boundedTopLeft(const QPoint &preferredTopLeft, const QSize &windowSize, const QRect &bounds)
 {
     const int maxX = std::max(bounds.left(), bounds.right() - windowSize.width() + 1);
@@ -123,21 +171,10 @@ MainWindow::MainWindow(QWidget *parent)
         m_dxccModel->setHeaderData(dxccEntityCol, Qt::Horizontal, "Entity");
     }
 
-    m_spotModel = new QSqlTableModel(this);
-    m_spotModel->setTable("spots");
-    m_spotModel->setEditStrategy(QSqlTableModel::OnFieldChange);
-    const int timeCol = m_spotModel->fieldIndex("time");
-    if (timeCol >= 0) {
-        m_spotModel->setSort(timeCol, Qt::DescendingOrder);
-    }
-    m_spotModel->setHeaderData(0, Qt::Horizontal, "Time");
-    m_spotModel->setHeaderData(1, Qt::Horizontal, "Call");
-    m_spotModel->setHeaderData(2, Qt::Horizontal, "Freq");
-    m_spotModel->setHeaderData(3, Qt::Horizontal, "Mode");
-    m_spotModel->setHeaderData(4, Qt::Horizontal, "Country");
-    m_spotModel->setHeaderData(5, Qt::Horizontal, "Spotter");
-    m_spotModel->setHeaderData(6, Qt::Horizontal, "Message");
-    m_spotModel->select();
+    // Spots live in memory; the table is read once and then only written.
+    m_spotModel = new SpotTableModel(SpotTableModel::kDefaultCapacity, this);
+    m_spotModel->load();
+    m_spotFilter = new SpotFilterModel(m_spotModel, this);
 
     auto setupModesView = [this](QTableView *view, QAbstractItemModel *model, QStyledItemDelegate *delegate, bool hideFirstColumn) {
         if (!view || !model) {
@@ -170,7 +207,7 @@ MainWindow::MainWindow(QWidget *parent)
     setupModesView(ui->tableView, m_model, checkboxDelegate, true);
     setupModesView(ui->dxccTableView, m_dxccModel, nullptr, false);
     if (ui->spotTableView) {
-        ui->spotTableView->setModel(m_spotModel);
+        ui->spotTableView->setModel(m_spotFilter);
         ui->spotTableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
         ui->spotTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
         ui->spotTableView->setStyleSheet(
@@ -178,12 +215,10 @@ MainWindow::MainWindow(QWidget *parent)
         if (ui->spotTableView->verticalHeader()) {
             ui->spotTableView->verticalHeader()->setVisible(false);
         }
-        const int spotIdCol = m_spotModel ? m_spotModel->fieldIndex("id") : -1;
-        if (spotIdCol >= 0) {
-            ui->spotTableView->setColumnHidden(spotIdCol, true);
-        }
         if (ui->spotTableView->horizontalHeader()) {
             ui->spotTableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+            // Measure the visible rows only, not the whole retained history.
+            ui->spotTableView->horizontalHeader()->setResizeContentsPrecision(0);
         }
         if (ui->spotTab) {
             auto *selectAllSpotShortcut = new QShortcut(QKeySequence::SelectAll, ui->spotTab);
@@ -192,98 +227,32 @@ MainWindow::MainWindow(QWidget *parent)
         }
     }
     QSettings filterSettings;
-    auto loadSpotFilterCheck = [&filterSettings](QCheckBox *checkBox, const QString &key) {
-        if (!checkBox) {
-            return;
+    for (const SpotFilterCheck &check : spotFilterChecks(ui)) {
+        if (check.box) {
+            check.box->setChecked(filterSettings.value(check.key, check.box->isChecked()).toBool());
         }
-        const bool defaultValue = checkBox->isChecked();
-        checkBox->setChecked(filterSettings.value(key, defaultValue).toBool());
-    };
-    loadSpotFilterCheck(ui->spotBand160CheckBox, "spotFilters/band160");
-    loadSpotFilterCheck(ui->spotBand80CheckBox, "spotFilters/band80");
-    loadSpotFilterCheck(ui->spotBand40CheckBox, "spotFilters/band40");
-    loadSpotFilterCheck(ui->spotBand30CheckBox, "spotFilters/band30");
-    loadSpotFilterCheck(ui->spotBand20CheckBox, "spotFilters/band20");
-    loadSpotFilterCheck(ui->spotBand17CheckBox, "spotFilters/band17");
-    loadSpotFilterCheck(ui->spotBand15CheckBox, "spotFilters/band15");
-    loadSpotFilterCheck(ui->spotBand12CheckBox, "spotFilters/band12");
-    loadSpotFilterCheck(ui->spotBand10CheckBox, "spotFilters/band10");
-    loadSpotFilterCheck(ui->spotBand6CheckBox, "spotFilters/band6");
-    loadSpotFilterCheck(ui->spotBand2CheckBox, "spotFilters/band2");
-    loadSpotFilterCheck(ui->spotModeCwCheckBox, "spotFilters/modeCW");
-    loadSpotFilterCheck(ui->spotModePhCheckBox, "spotFilters/modePH");
-    loadSpotFilterCheck(ui->spotModeRtCheckBox, "spotFilters/modeRT");
-    loadSpotFilterCheck(ui->spotModeSatCheckBox, "spotFilters/modeSAT");
-    loadSpotFilterCheck(ui->spotterAfCheckBox, "spotFilters/spotterAF");
-    loadSpotFilterCheck(ui->spotterAnCheckBox, "spotFilters/spotterAN");
-    loadSpotFilterCheck(ui->spotterAsCheckBox, "spotFilters/spotterAS");
-    loadSpotFilterCheck(ui->spotterEuCheckBox, "spotFilters/spotterEU");
-    loadSpotFilterCheck(ui->spotterNaCheckBox, "spotFilters/spotterNA");
-    loadSpotFilterCheck(ui->spotterOcCheckBox, "spotFilters/spotterOC");
-    loadSpotFilterCheck(ui->spotterSaCheckBox, "spotFilters/spotterSA");
-
-    auto connectSpotBandCheckbox = [this](QCheckBox *checkBox) {
-        if (!checkBox) {
-            return;
+    }
+    // Toggles refilter at once; a burst of them is saved once, afterwards.
+    spotFilterSaveTimer = new QTimer(this);
+    spotFilterSaveTimer->setSingleShot(true);
+    spotFilterSaveTimer->setInterval(kSpotFilterSaveDelayMs);
+    connect(spotFilterSaveTimer, &QTimer::timeout, this, &MainWindow::saveSpotFilterChecks);
+    for (const SpotFilterCheck &check : spotFilterChecks(ui)) {
+        if (!check.box) {
+            continue;
         }
-        connect(checkBox, &QCheckBox::toggled, this, [this](bool) {
-            QSettings settings;
-            const auto saveSpotFilterCheck = [&settings](QCheckBox *box, const QString &key) {
-                if (!box) {
-                    return;
-                }
-                settings.setValue(key, box->isChecked());
-            };
-            saveSpotFilterCheck(ui->spotBand160CheckBox, "spotFilters/band160");
-            saveSpotFilterCheck(ui->spotBand80CheckBox, "spotFilters/band80");
-            saveSpotFilterCheck(ui->spotBand40CheckBox, "spotFilters/band40");
-            saveSpotFilterCheck(ui->spotBand30CheckBox, "spotFilters/band30");
-            saveSpotFilterCheck(ui->spotBand20CheckBox, "spotFilters/band20");
-            saveSpotFilterCheck(ui->spotBand17CheckBox, "spotFilters/band17");
-            saveSpotFilterCheck(ui->spotBand15CheckBox, "spotFilters/band15");
-            saveSpotFilterCheck(ui->spotBand12CheckBox, "spotFilters/band12");
-            saveSpotFilterCheck(ui->spotBand10CheckBox, "spotFilters/band10");
-            saveSpotFilterCheck(ui->spotBand6CheckBox, "spotFilters/band6");
-            saveSpotFilterCheck(ui->spotBand2CheckBox, "spotFilters/band2");
-            saveSpotFilterCheck(ui->spotModeCwCheckBox, "spotFilters/modeCW");
-            saveSpotFilterCheck(ui->spotModePhCheckBox, "spotFilters/modePH");
-            saveSpotFilterCheck(ui->spotModeRtCheckBox, "spotFilters/modeRT");
-            saveSpotFilterCheck(ui->spotModeSatCheckBox, "spotFilters/modeSAT");
-            saveSpotFilterCheck(ui->spotterAfCheckBox, "spotFilters/spotterAF");
-            saveSpotFilterCheck(ui->spotterAnCheckBox, "spotFilters/spotterAN");
-            saveSpotFilterCheck(ui->spotterAsCheckBox, "spotFilters/spotterAS");
-            saveSpotFilterCheck(ui->spotterEuCheckBox, "spotFilters/spotterEU");
-            saveSpotFilterCheck(ui->spotterNaCheckBox, "spotFilters/spotterNA");
-            saveSpotFilterCheck(ui->spotterOcCheckBox, "spotFilters/spotterOC");
-            saveSpotFilterCheck(ui->spotterSaCheckBox, "spotFilters/spotterSA");
+        connect(check.box, &QCheckBox::toggled, this, [this](bool) {
             updateSpotBandFilter();
+            spotFilterSaveTimer->start();
         });
-    };
-    connectSpotBandCheckbox(ui->spotBand80CheckBox);
-    connectSpotBandCheckbox(ui->spotBand40CheckBox);
-    connectSpotBandCheckbox(ui->spotBand30CheckBox);
-    connectSpotBandCheckbox(ui->spotBand20CheckBox);
-    connectSpotBandCheckbox(ui->spotBand17CheckBox);
-    connectSpotBandCheckbox(ui->spotBand15CheckBox);
-    connectSpotBandCheckbox(ui->spotBand12CheckBox);
-    connectSpotBandCheckbox(ui->spotBand10CheckBox);
-    connectSpotBandCheckbox(ui->spotBand6CheckBox);
-    connectSpotBandCheckbox(ui->spotBand160CheckBox);
-    connectSpotBandCheckbox(ui->spotBand2CheckBox);
-    connectSpotBandCheckbox(ui->spotModeCwCheckBox);
-    connectSpotBandCheckbox(ui->spotModePhCheckBox);
-    connectSpotBandCheckbox(ui->spotModeRtCheckBox);
-    connectSpotBandCheckbox(ui->spotModeSatCheckBox);
-    connectSpotBandCheckbox(ui->spotterAfCheckBox);
-    connectSpotBandCheckbox(ui->spotterAnCheckBox);
-    connectSpotBandCheckbox(ui->spotterAsCheckBox);
-    connectSpotBandCheckbox(ui->spotterEuCheckBox);
-    connectSpotBandCheckbox(ui->spotterNaCheckBox);
-    connectSpotBandCheckbox(ui->spotterOcCheckBox);
-    connectSpotBandCheckbox(ui->spotterSaCheckBox);
+    }
     updateSpotBandFilter();
     if (dxccIdCol >= 0 && ui->dxccTableView) {
         ui->dxccTableView->setColumnHidden(dxccIdCol, true);
+    }
+    const int dxccCodeCol = m_dxccModel->fieldIndex("dxcc");
+    if (dxccCodeCol >= 0 && ui->dxccTableView) {
+        ui->dxccTableView->setColumnHidden(dxccCodeCol, true);
     }
     if (ui->dxccTableView && ui->dxccTableView->horizontalHeader()) {
         auto *header = ui->dxccTableView->horizontalHeader();
@@ -308,123 +277,6 @@ MainWindow::MainWindow(QWidget *parent)
     }
 
 
-    rbnSocket = new QTcpSocket(this);
-    connect(rbnSocket, &QTcpSocket::readyRead, this, [this]() {
-        const QByteArray data = rbnSocket->readAll();
-        if (data.isEmpty()) {
-            return;
-        }
-
-        rbnBuffer.append(data);
-        // qDebug().noquote() << "RBN:" << data;
-
-        static const QRegularExpression rbnLineRegex(
-            R"(^DX de\s+\S+:\s+([0-9.]+)\s+([A-Za-z0-9/]+)\b(?:\s+([A-Za-z0-9/]+))?)"
-            );
-        auto freqToBand = [](double value) -> QString {
-            // RBN spots often use kHz (e.g. 14074.0); normalize to MHz.
-            double mhz = value;
-            if (mhz > 1000.0) {
-                mhz /= 1000.0;
-            }
-
-            if (mhz >= 1.8 && mhz < 2.0) return "160";
-            if (mhz >= 3.5 && mhz < 4.0) return "80";
-            if (mhz >= 7.0 && mhz < 7.3) return "40";
-            if (mhz >= 10.1 && mhz < 10.15) return "30";
-            if (mhz >= 14.0 && mhz < 14.35) return "20";
-            if (mhz >= 18.068 && mhz < 18.168) return "17";
-            if (mhz >= 21.0 && mhz < 21.45) return "15";
-            if (mhz >= 24.89 && mhz < 24.99) return "12";
-            if (mhz >= 28.0 && mhz < 29.7) return "10";
-            if (mhz >= 144.0 && mhz < 148.0) return "2";
-            return QString();
-        };
-
-        if (rbnOutputPaused) {
-            if (!rbnLoginSent && rbnBuffer.contains("Please enter your call:")) {
-                rbnSocket->write("OG3Z\r\n");
-                rbnLoginSent = true;
-                qDebug() << "RBN login sent";
-            }
-            rbnBuffer.clear();
-            return;
-        }
-
-        while (true) {
-            const int newlineIndex = rbnBuffer.indexOf('\n');
-            if (newlineIndex < 0) {
-                break;
-            }
-
-            const QByteArray lineBytes = rbnBuffer.left(newlineIndex);
-            rbnBuffer.remove(0, newlineIndex + 1);
-
-            const QString line = QString::fromUtf8(lineBytes).trimmed();
-            if (line.isEmpty()) {
-                continue;
-            }
-
-            //qDebug().noquote() << line;
-
-            const QRegularExpressionMatch match = rbnLineRegex.match(line);
-            if (match.hasMatch()) {
-                const QString freq = match.captured(1);
-                const QString call = match.captured(2);
-                const QString callUp = call.trimmed().toUpper();
-                const QString mode = match.captured(3).trimmed().toUpper();
-                const double freqValue = freq.toDouble();
-                const QString band = freqToBand(freqValue);
-                // qDebug().noquote() << "RBN spot:" << "call=" << call << "freq=" << freq;
-
-                if (band.isEmpty()) {
-                    return;
-                }
-
-                QSqlQuery q;
-                const QString sql = QString(R"(SELECT "%1" FROM modes WHERE callsign = ? LIMIT 1)").arg(band);
-                q.prepare(sql);
-                q.addBindValue(callUp);
-                if (!q.exec()) {
-                    qWarning() << "RBN DB lookup failed:" << q.lastError();
-                } else if (q.next()) {
-                    const int mask = q.value(0).toInt();
-                    //qDebug().noquote() << "RBN in DB:" << callUp;
-                    if (!(mask & (1 << 0))) {
-                        //qDebug().noquote() << callUp << mode << freq;
-                        if (mode == "CW" && !rbnLabelsFrozen) {
-                            if (ui->callLabel) {
-                                ui->callLabel->setText(callUp);
-                            }
-                            if (ui->freqLabel) {
-                                ui->freqLabel->setText(freq);
-                            }
-                        } else {
-                            //qDebug() << "RBN non-CW:" << callUp << freq << "mode" << (mode.isEmpty() ? "<none>" : mode);
-                        }
-                    }
-                }
-            }
-        }
-
-        if (!rbnLoginSent && rbnBuffer.contains("Please enter your call:")) {
-            rbnSocket->write("OG3Z\r\n");
-            rbnLoginSent = true;
-            qDebug() << "RBN login sent";
-        }
-    });
-    connect(rbnSocket,
-            QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred),
-            this, [this](QAbstractSocket::SocketError) {
-                qWarning() << "RBN socket error:" << rbnSocket->errorString();
-            });
-    connect(rbnSocket, &QTcpSocket::connected, this, [this]() {
-        qDebug() << "RBN connected";
-    });
-    connect(rbnSocket, &QTcpSocket::disconnected, this, [this]() {
-        qWarning() << "RBN disconnected";
-    });
-    rbnSocket->connectToHost("telnet.reversebeacon.net", 7000);
     connect(ui->clearButton, &QPushButton::clicked, this, &MainWindow::onClearClicked);
     auto connectStatusRefreshSignals = [this](QAbstractItemModel *model) {
         if (!model) {
@@ -486,9 +338,63 @@ MainWindow::MainWindow(QWidget *parent)
         connect(ui->spotDeleteButton, &QPushButton::clicked, this, &MainWindow::onSpotDeleteClicked);
     }
 
-    tcpReceiver = std::make_unique<TcpReceiver>("ham.connect.fi", 7300, this);
-    connect(tcpReceiver.get(), &TcpReceiver::spotReceived, this, &MainWindow::onSpotReceived);
-    tcpReceiver->start();
+    ctyWatcher = new CtyWatcher(Country::defaultSources(), this);
+
+    neededMatrix.load();
+    // Edits in the DXCC tab change what is needed; the table is small enough
+    // to reload whole.
+    connect(m_dxccModel, &QAbstractItemModel::dataChanged, this, [this]() {
+        neededMatrix.load();
+    });
+
+    // Spots reach the table in batches, behind the view.
+    QSettings writerSettings;
+    m_spotWriter = new SpotWriter(QSqlDatabase::database(), this);
+    m_spotWriter->setFlushInterval(writerSettings.value("spots/flushIntervalMs", SpotWriter::kDefaultFlushIntervalMs).toInt());
+    m_spotWriter->setMaxBatch(writerSettings.value("spots/flushBatch", SpotWriter::kDefaultMaxBatch).toInt());
+    connect(m_spotWriter, &SpotWriter::flushed, this, [this](int count, qint64 elapsedUs) {
+        if (statusInfoLabel) {
+            statusInfoLabel->setToolTip(QString("Spot writes: %1 queued, last flush %2 spots in %3 ms, slowest %4 ms")
+                                            .arg(m_spotWriter->queueDepth())
+                                            .arg(count)
+                                            .arg(elapsedUs / 1000.0, 0, 'f', 1)
+                                            .arg(m_spotWriter->maxFlushUs() / 1000.0, 0, 'f', 1));
+        }
+    });
+
+    // Cluster and RBN clients run on their own thread; spots arrive batched.
+    feedThread = new QThread(this);
+    spotFeeds = new SpotFeeds(&neededMatrix);
+    spotFeeds->moveToThread(feedThread);
+    connect(feedThread, &QThread::started, spotFeeds, &SpotFeeds::start);
+    connect(feedThread, &QThread::finished, spotFeeds, &QObject::deleteLater);
+    connect(spotFeeds, &SpotFeeds::clusterSpots, this, &MainWindow::onClusterSpots);
+    connect(spotFeeds, &SpotFeeds::rbnSpot, this, [this](const RbnAggregate &spot) {
+        if (rbnLabelsFrozen) {
+            return;
+        }
+        if (ui->callLabel) {
+            ui->callLabel->setText(spot.call);
+            ui->callLabel->setToolTip(QString("%1\n%2 skimmers (%3), %4..%5 dB, %6 WPM")
+                                          .arg(Country::shared()->GetCountry(spot.call))
+                                          .arg(spot.skimmers)
+                                          .arg(spot.continents.join(' '))
+                                          .arg(spot.minSnr)
+                                          .arg(spot.maxSnr)
+                                          .arg(spot.speed));
+        }
+        if (ui->freqLabel) {
+            ui->freqLabel->setText(QString::number(spot.hz / 1000.0, 'f', 1));
+        }
+    });
+    feedThread->start();
+
+    // Expired spots go in batches on a timer, not on the insert path.
+    spotRetentionTimer = new QTimer(this);
+    spotRetentionTimer->setInterval(kSpotExpiryIntervalMs);
+    connect(spotRetentionTimer, &QTimer::timeout, this, &MainWindow::expireSpots);
+    spotRetentionTimer->start();
+    expireSpots();
 
     connect(ui->morseSpeed, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, [this](int) {
@@ -619,137 +525,66 @@ static QChar vfoToPrefix(vfo_t vfo)
     }
 }
 
-static QString bandFromFrequencyText(const QString &freqText)
-{
-    bool ok = false;
-    const double value = freqText.toDouble(&ok);
-    if (!ok || value <= 0.0) {
-        return QString();
-    }
-
-    double mhz = value;
-    if (mhz > 1000.0) {
-        mhz /= 1000.0;
-    }
-
-    if (mhz >= 1.8 && mhz < 2.0) return "160";
-    if (mhz >= 3.5 && mhz < 4.0) return "80";
-    if (mhz >= 7.0 && mhz < 7.3) return "40";
-    if (mhz >= 10.1 && mhz < 10.15) return "30";
-    if (mhz >= 14.0 && mhz < 14.35) return "20";
-    if (mhz >= 18.068 && mhz < 18.168) return "17";
-    if (mhz >= 21.0 && mhz < 21.45) return "15";
-    if (mhz >= 24.89 && mhz < 24.99) return "12";
-    if (mhz >= 28.0 && mhz < 29.7) return "10";
-    if (mhz >= 144.0 && mhz < 148.0) return "2";
-    return QString();
-}
-
 void MainWindow::updateSpotBandFilter()
 {
-    if (!m_spotModel || !ui) {
+    if (!m_spotFilter || !ui) {
         return;
     }
 
-    const QString mhzExpr = "(CASE WHEN CAST(freq AS REAL) > 1000 THEN CAST(freq AS REAL) / 1000.0 ELSE CAST(freq AS REAL) END)";
-    QStringList bandClauses;
-    int checkedBandCount = 0;
-
-    auto addBandClause = [&](QCheckBox *checkBox, const char *low, const char *high) {
-        if (!checkBox || !checkBox->isChecked()) {
-            return;
-        }
-        ++checkedBandCount;
-        bandClauses << QString("(%1 >= %2 AND %1 < %3)").arg(mhzExpr, low, high);
-    };
-
-    addBandClause(ui->spotBand160CheckBox, "1.8", "2.0");
-    addBandClause(ui->spotBand80CheckBox, "3.5", "4.0");
-    addBandClause(ui->spotBand40CheckBox, "7.0", "7.3");
-    addBandClause(ui->spotBand30CheckBox, "10.1", "10.15");
-    addBandClause(ui->spotBand20CheckBox, "14.0", "14.35");
-    addBandClause(ui->spotBand17CheckBox, "18.068", "18.168");
-    addBandClause(ui->spotBand15CheckBox, "21.0", "21.45");
-    addBandClause(ui->spotBand12CheckBox, "24.89", "24.99");
-    addBandClause(ui->spotBand10CheckBox, "28.0", "29.7");
-    addBandClause(ui->spotBand6CheckBox, "50.0", "54.0");
-    addBandClause(ui->spotBand2CheckBox, "144.0", "148.0");
-
-    QStringList filterGroups;
-    if (checkedBandCount < 11) {
-        if (bandClauses.isEmpty()) {
-            m_spotModel->setFilter("1 = 0");
-            m_spotModel->select();
-            return;
+    quint32 offered = 0;
+    quint32 checked = 0;
+    for (const SpotFilterCheck &check : spotFilterChecks(ui)) {
+        if (check.box) {
+            offered |= check.bit;
+            if (check.box->isChecked()) {
+                checked |= check.bit;
+            }
         }
-        filterGroups << QString("(%1)").arg(bandClauses.join(" OR "));
     }
-
-    QStringList modeClauses;
-    int checkedModeCount = 0;
-    auto addSimpleModeClause = [&](QCheckBox *checkBox, const char *modeValue) {
-        if (!checkBox || !checkBox->isChecked()) {
-            return;
-        }
-        ++checkedModeCount;
-        modeClauses << QString("(UPPER(mode) = '%1')").arg(modeValue);
-    };
-    addSimpleModeClause(ui->spotModeCwCheckBox, "CW");
-    addSimpleModeClause(ui->spotModePhCheckBox, "PH");
-    addSimpleModeClause(ui->spotModeRtCheckBox, "RT");
-    addSimpleModeClause(ui->spotModeSatCheckBox, "SAT");
-
-    if (checkedModeCount < 4) {
-        if (modeClauses.isEmpty()) {
-            m_spotModel->setFilter("1 = 0");
-            m_spotModel->select();
-            return;
+    // A group with every box checked rejects nothing, so spots whose value
+    // is unknown still show; otherwise everything unchecked is rejected.
+    quint32 rejected = 0;
+    for (const quint32 group : {SpotFilter::kBands, SpotFilter::kModes, SpotFilter::kContinents}) {
+        if ((checked & group) != (offered & group)) {
+            rejected |= group & ~checked;
         }
-        filterGroups << QString("(%1)").arg(modeClauses.join(" OR "));
     }
+    m_spotFilter->setRejected(rejected);
+}
 
-    QStringList spotterContClauses;
-    int checkedSpotterContCount = 0;
-    auto addSpotterContClause = [&](QCheckBox *checkBox, const char *continent) {
-        if (!checkBox || !checkBox->isChecked()) {
-            return;
-        }
-        ++checkedSpotterContCount;
-        spotterContClauses << QString("(UPPER(TRIM(spotter)) = '%1')").arg(continent);
-    };
-    addSpotterContClause(ui->spotterAfCheckBox, "AF");
-    addSpotterContClause(ui->spotterAnCheckBox, "AN");
-    addSpotterContClause(ui->spotterAsCheckBox, "AS");
-    addSpotterContClause(ui->spotterEuCheckBox, "EU");
-    addSpotterContClause(ui->spotterNaCheckBox, "NA");
-    addSpotterContClause(ui->spotterOcCheckBox, "OC");
-    addSpotterContClause(ui->spotterSaCheckBox, "SA");
-
-    if (checkedSpotterContCount < 7) {
-        if (spotterContClauses.isEmpty()) {
-            m_spotModel->setFilter("1 = 0");
-            m_spotModel->select();
-            return;
-        }
-        filterGroups << QString("(%1)").arg(spotterContClauses.join(" OR "));
+void MainWindow::saveSpotFilterChecks()
+{
+    if (!ui) {
+        return;
     }
-
-    if (filterGroups.isEmpty()) {
-        m_spotModel->setFilter(QString());
-    } else {
-        m_spotModel->setFilter(filterGroups.join(" AND "));
+    QSettings settings;
+    for (const SpotFilterCheck &check : spotFilterChecks(ui)) {
+        if (check.box) {
+            settings.setValue(check.key, check.box->isChecked());
+        }
     }
-    m_spotModel->select();
 }
 
 MainWindow::~MainWindow()
 {
+    if (feedThread) {
+        feedThread->quit();
+        feedThread->wait();
+    }
+    // No spots arrive once the feeds are down; write what is still queued.
+    if (m_spotWriter) {
+        m_spotWriter->flush();
+    }
     delete ui;
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
     saveWindowPlacement();
+    if (spotFilterSaveTimer && spotFilterSaveTimer->isActive()) {
+        spotFilterSaveTimer->stop();
+        saveSpotFilterChecks();
+    }
     QMainWindow::closeEvent(event);
 }
 
@@ -1162,6 +997,9 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 
     if (obj == ui->statusbar && event->type() == QEvent::MouseButtonPress) {
         rbnOutputPaused = !rbnOutputPaused;
+        if (spotFeeds) {
+            spotFeeds->setRbnPaused(rbnOutputPaused);
+        }
         if (statusInfoLabel) {
             statusInfoLabel->setStyleSheet(rbnOutputPaused ? "color: red;" : "");
         }
@@ -1216,7 +1054,7 @@ void MainWindow::onClearClicked()
 
 void MainWindow::onLogClicked()
 {
-    const QString call = ui->callLabel ? ui->callLabel->text().trimmed().toUpper() : QString();
+    const QString call = ui->callLabel ? QString(Callsign(ui->callLabel->text()).base()) : QString();
     const QString freqText = ui->freqLabel ? ui->freqLabel->text().trimmed() : QString();
     if (call.isEmpty() || freqText.isEmpty()) {
         if (statusInfoLabel) {
@@ -1225,7 +1063,7 @@ void MainWindow::onLogClicked()
         return;
     }
 
-    const QString band = bandFromFrequencyText(freqText);
+    const QString band = bandName(bandForHz(frequencyHz(freqText)));
     if (band.isEmpty()) {
         if (statusInfoLabel) {
             statusInfoLabel->setText("Log failed");
@@ -1254,6 +1092,9 @@ void MainWindow::onLogClicked()
         statusInfoLabel->setText("Logged");
     }
     rbnOutputPaused = false;
+    if (spotFeeds) {
+        spotFeeds->setRbnPaused(false);
+    }
     if (statusInfoLabel) {
         statusInfoLabel->setStyleSheet("");
     }
@@ -1284,21 +1125,10 @@ void MainWindow::onDxccReadAdiClicked()
     const QStringList records = content.split(QRegularExpression(R"(<\s*EOR\s*>)", QRegularExpression::CaseInsensitiveOption), Qt::SkipEmptyParts);
     const QRegularExpression fieldRe(R"(<\s*([^:>\s]+)\s*:\s*([0-9]+)[^>]*>([^<]*))", QRegularExpression::CaseInsensitiveOption);
 
-    auto normalizeBand = [](const QString &bandText) -> QString {
-        QString band = bandText.trimmed().toUpper();
-        if (band.endsWith('M')) {
-            band.chop(1);
-        }
-        if (band == "2" || band == "6" || band == "10" || band == "12" ||
-            band == "15" || band == "17" || band == "20" || band == "30" ||
-            band == "40" || band == "80" || band == "160") {
-            return band;
-        }
-        return QString();
-    };
-
     const QSqlDatabase db = QSqlDatabase::database();
 
+    QVector<QMap<QString, QString>> qsos;
+    qsos.reserve(records.size());
     for (const QString &record : records) {
         QMap<QString, QString> fields;
         auto it = fieldRe.globalMatch(record);
@@ -1317,40 +1147,67 @@ void MainWindow::onDxccReadAdiClicked()
         if (deleted.compare("Yes", Qt::CaseInsensitive) == 0) {
             continue;
         }
+        qsos.append(fields);
+    }
 
-        const QString call = fields.value("CALL").trimmed().toUpper();
+    // Entity by ADIF DXCC code, falling back to the COUNTRY name and then
+    // the call. Calls are resolved together in one batch.
+    QVector<int> codes(qsos.size(), 0);
+    QVector<QString> unresolvedCalls;
+    QVector<int> unresolvedQsos;
+    for (int i = 0; i < qsos.size(); ++i) {
+        const QMap<QString, QString> &fields = qsos.at(i);
+        int dxcc = fields.value("DXCC").trimmed().toInt();
+        if (dxcc == 0) {
+            const DxccEntity *entity = dxccEntityForName(fields.value("COUNTRY"));
+            dxcc = entity ? entity->code : 0;
+        }
+        const QString call = fields.value("CALL").trimmed();
+        if (dxcc == 0 && !call.isEmpty()) {
+            unresolvedCalls.append(call);
+            unresolvedQsos.append(i);
+        }
+        codes[i] = dxcc;
+    }
+    const QVector<CallInfo> resolved = Country::shared()->lookupBatch(unresolvedCalls);
+    for (int i = 0; i < resolved.size(); ++i) {
+        codes[unresolvedQsos.at(i)] = resolved.at(i).dxcc;
+    }
+
+    for (int i = 0; i < qsos.size(); ++i) {
+        const QMap<QString, QString> &fields = qsos.at(i);
+        const int dxcc = codes.at(i);
         const QString modeGroup = fields.value("APP_LOTW_MODEGROUP").trimmed().toUpper();
         const QString bandRaw = fields.value("BAND").trimmed().toUpper();
-        QString country = fields.value("COUNTRY").trimmed();
-        if (country.isEmpty()) {
-            country = fields.value("DXCC").trimmed();
-        }
-        const QString entityKey = country.trimmed().toUpper();
 
-        if (!entityKey.isEmpty()) {
+        if (dxcc != 0) {
             QSqlQuery q(db);
-            const QString sql = QString("UPDATE dxcc SET Mix = 'X' WHERE entity = ?");
+            const QString sql = QString("UPDATE dxcc SET Mix = 'X' WHERE dxcc = ?");
             q.prepare(sql);
-            q.addBindValue(entityKey);
+            q.addBindValue(dxcc);
             if (!q.exec()) {
                 qWarning() << "DXCC mix update failed:" << q.lastError();
+            } else {
+                neededMatrix.mark(dxcc, NeededMatrix::Mix);
             }
         }
 
-        const QString band = normalizeBand(bandRaw);
+        const QString band = bandName(bandForName(bandRaw));
         const bool validMode = (modeGroup == "CW" || modeGroup == "PHONE" || modeGroup == "DATA");
-        if (!entityKey.isEmpty() && !band.isEmpty() && validMode) {
+        if (dxcc != 0 && !band.isEmpty() && validMode) {
             const QString column = QString("\"%1\"").arg(band);
             QSqlQuery q(db);
-            const QString sql = QString("UPDATE dxcc SET %1 = 'V' WHERE entity = ?").arg(column);
+            const QString sql = QString("UPDATE dxcc SET %1 = 'V' WHERE dxcc = ?").arg(column);
             q.prepare(sql);
-            q.addBindValue(entityKey);
+            q.addBindValue(dxcc);
             if (!q.exec()) {
                 qWarning() << "DXCC update failed:" << q.lastError();
+            } else {
+                neededMatrix.mark(dxcc, NeededMatrix::columnForName(band));
             }
         }
 
-        if (!entityKey.isEmpty() && validMode) {
+        if (dxcc != 0 && validMode) {
             QString modeColumn;
             if (modeGroup == "PHONE") {
                 modeColumn = "Ph";
@@ -1361,28 +1218,32 @@ void MainWindow::onDxccReadAdiClicked()
             }
             if (!modeColumn.isEmpty()) {
                 QSqlQuery q(db);
-                const QString sql = QString("UPDATE dxcc SET %1 = 'X' WHERE entity = ?").arg(modeColumn);
+                const QString sql = QString("UPDATE dxcc SET %1 = 'X' WHERE dxcc = ?").arg(modeColumn);
                 q.prepare(sql);
-                q.addBindValue(entityKey);
+                q.addBindValue(dxcc);
                 if (!q.exec()) {
                     qWarning() << "DXCC mode update failed:" << q.lastError();
+                } else {
+                    neededMatrix.mark(dxcc, NeededMatrix::columnForName(modeColumn));
                 }
             }
         }
 
         const QString propMode = fields.value("PROP_MODE").trimmed().toUpper();
-        if (!entityKey.isEmpty() && propMode == "SAT") {
+        if (dxcc != 0 && propMode == "SAT") {
             QSqlQuery q(db);
-            const QString sql = QString("UPDATE dxcc SET SAT = 'X' WHERE entity = ?");
+            const QString sql = QString("UPDATE dxcc SET SAT = 'X' WHERE dxcc = ?");
             q.prepare(sql);
-            q.addBindValue(entityKey);
+            q.addBindValue(dxcc);
             if (!q.exec()) {
                 qWarning() << "DXCC SAT update failed:" << q.lastError();
+            } else {
+                neededMatrix.mark(dxcc, NeededMatrix::Sat);
             }
         }
 
-        // if (!call.isEmpty() || !bandRaw.isEmpty() || !modeGroup.isEmpty() || !country.isEmpty()) {
-        //     qDebug().noquote() << "ADI" << call << modeGroup << bandRaw << country;
+        // if (!bandRaw.isEmpty() || !modeGroup.isEmpty() || dxcc != 0) {
+        //     qDebug().noquote() << "ADI" << fields.value("CALL") << modeGroup << bandRaw << dxcc;
         // }
     }
     if (m_dxccModel) {
@@ -1396,102 +1257,78 @@ void MainWindow::onDxccReadAdiClicked()
 
 void MainWindow::onSpotDeleteClicked()
 {
-    if (!m_spotModel || !ui || !ui->spotTableView) {
+    if (!m_spotModel || !m_spotFilter || !ui || !ui->spotTableView) {
         return;
     }
     QItemSelectionModel *selection = ui->spotTableView->selectionModel();
     if (!selection) {
         return;
     }
-    QModelIndexList rows = selection->selectedRows();
-    if (rows.isEmpty()) {
+    const QModelIndexList selected = selection->selectedRows();
+    if (selected.isEmpty()) {
         return;
     }
-    std::sort(rows.begin(), rows.end(), [](const QModelIndex &a, const QModelIndex &b) {
-        return a.row() > b.row();
-    });
-    for (const QModelIndex &idx : rows) {
-        m_spotModel->removeRow(idx.row());
+    // Queued spots must be in the table for their delete to match.
+    if (m_spotWriter) {
+        m_spotWriter->flush();
+    }
+
+    QVector<int> rows;
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    QSqlQuery del;
+    // By rowid, so another spot of the same call, time and frequency stays.
+    del.prepare("DELETE FROM spots WHERE rowid = ?");
+    for (const QModelIndex &idx : selected) {
+        const int row = m_spotFilter->mapToSource(idx).row();
+        const DxSpot &spot = m_spotModel->spot(row);
+        rows.append(row);
+        if (spot.id == 0) {
+            continue;
+        }
+        del.addBindValue(spot.id);
+        if (!del.exec()) {
+            qWarning() << "Spot delete failed:" << del.lastError();
+        }
+    }
+    if (!db.commit()) {
+        qWarning() << "Spot delete commit failed:" << db.lastError();
+        db.rollback();
+        return;
     }
-    if (!m_spotModel->submitAll()) {
-        qWarning() << "Spot delete failed:" << m_spotModel->lastError();
-        m_spotModel->revertAll();
+    m_spotModel->removeSpotRows(rows);
+}
+
+void MainWindow::onClusterSpots(const QVector<DxSpot> &spots)
+{
+    // The view updates now; the table catches up on the writer's next flush.
+    const QVector<DxSpot> numbered = m_spotWriter ? m_spotWriter->enqueue(spots) : spots;
+    if (m_spotModel) {
+        m_spotModel->addSpots(numbered);
     }
-    m_spotModel->select();
 }
 
-void MainWindow::onSpotReceived(const QString &time,
-                                const QString &call,
-                                const QString &freq,
-                                const QString &mode,
-                                const QString &country,
-                                const QString &spotter,
-                                const QString &message)
+void MainWindow::expireSpots()
 {
-    QSqlQuery q;
-    q.prepare(R"(
-        INSERT INTO spots (time, call, freq, mode, country, spotter, message)
-        VALUES (?, ?, ?, ?, ?, ?, ?)
-    )");
-    q.addBindValue(time);
-    q.addBindValue(call);
-    q.addBindValue(freq);
-    q.addBindValue(mode);
-    q.addBindValue(country);
-    q.addBindValue(spotter);
-    q.addBindValue(message);
-    if (!q.exec()) {
-        qWarning() << "Spot insert failed:" << q.lastError();
-    } else if (m_spotModel) {
-        const QDateTime nowUtc = QDateTime::currentDateTimeUtc();
-        const int nowMinutes = nowUtc.time().hour() * 60 + nowUtc.time().minute();
-        QSqlQuery select;
-        if (select.exec("SELECT rowid, time FROM spots")) {
-            QVector<qint64> toDelete;
-            while (select.next()) {
-                const qint64 rowid = select.value(0).toLongLong();
-                QString t = select.value(1).toString().trimmed().toUpper();
-                t.remove('Z');
-                t = t.trimmed();
-                if (t.size() < 4) {
-                    continue;
-                }
-                const QString hhmm = t.left(4);
-                bool ok = false;
-                const int hh = hhmm.left(2).toInt(&ok);
-                if (!ok) {
-                    continue;
-                }
-                const int mm = hhmm.mid(2, 2).toInt(&ok);
-                if (!ok) {
-                    continue;
-                }
-                if (hh < 0 || hh > 23 || mm < 0 || mm > 59) {
-                    continue;
-                }
-                const int spotMinutes = hh * 60 + mm;
-                int diff = nowMinutes - spotMinutes;
-                if (diff < 0) {
-                    diff += 24 * 60;
-                }
-                if (diff > 180) {
-                    toDelete.push_back(rowid);
-                }
-            }
-            if (!toDelete.isEmpty()) {
-                QSqlQuery del;
-                del.prepare("DELETE FROM spots WHERE rowid = ?");
-                for (const qint64 rowid : toDelete) {
-                    del.addBindValue(rowid);
-                    if (!del.exec()) {
-                        qWarning() << "Spot cleanup delete failed:" << del.lastError();
-                    }
-                    del.finish();
-                }
-            }
-        } else {
-            qWarning() << "Spot cleanup select failed:" << select.lastError();
+    QSettings settings;
+    const int retentionMinutes = settings.value("spots/retentionMinutes", kDefaultSpotRetentionMinutes).toInt();
+    const qint64 cutoff = QDateTime::currentSecsSinceEpoch() - qint64(retentionMinutes) * 60;
+
+    // Bounded batches keep each write lock short on a large backlog.
+    QSqlQuery del;
+    del.prepare("DELETE FROM spots WHERE rowid IN (SELECT rowid FROM spots WHERE ts < ? LIMIT ?)");
+    for (;;) {
+        del.addBindValue(cutoff);
+        del.addBindValue(kSpotExpiryBatch);
+        if (!del.exec()) {
+            qWarning() << "Spot expiry failed:" << del.lastError();
+            break;
         }
-        m_spotModel->select();
+        if (del.numRowsAffected() < kSpotExpiryBatch) {
+            break;
+        }
+    }
+    if (m_spotModel) {
+        m_spotModel->expireBefore(cutoff);
     }
 }
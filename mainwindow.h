@@ -5,7 +5,8 @@
 #include <QTimer>
 #include <memory>
 #include "rig.h"
-#include "tcpreceiver.h"
+#include "dxspot.h"
+#include "neededmatrix.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -27,24 +28,17 @@ public slots:
     void onLogClicked();
     void onDxccReadAdiClicked();
     void onSpotDeleteClicked();
-    void onSpotReceived(const QString &time,
-                        const QString &call,
-                        const QString &freq,
-                        const QString &mode,
-                        const QString &country,
-                        const QString &spotter,
-                        const QString &message);
+    void onClusterSpots(const QVector<DxSpot> &spots);
 
 private:
     Ui::MainWindow *ui;
     class QSqlTableModel *m_model = nullptr;
     class QSqlTableModel *m_dxccModel = nullptr;
-    class QSqlTableModel *m_spotModel = nullptr;
+    class SpotTableModel *m_spotModel = nullptr;
+    class SpotFilterModel *m_spotFilter = nullptr;
+    class SpotWriter *m_spotWriter = nullptr;
     class WwaDelegate *checkboxDelegate = nullptr;
 
-    class QTcpSocket *rbnSocket = nullptr;
-    QByteArray rbnBuffer;
-    bool rbnLoginSent = false;
     bool rbnOutputPaused = false;
     bool rbnLabelsFrozen = false;
     class QLabel *statusInfoLabel = nullptr;
@@ -54,10 +48,17 @@ private:
     void updateStatusCounts();
     void updateModeVisibility();
     void updateSpotBandFilter();
+    void saveSpotFilterChecks();
+    void expireSpots();
 
+    class CtyWatcher *ctyWatcher = nullptr;
+    NeededMatrix neededMatrix;
     std::unique_ptr<Rig> rig;
-    std::unique_ptr<TcpReceiver> tcpReceiver;
+    class QThread *feedThread = nullptr;
+    class SpotFeeds *spotFeeds = nullptr;
     QTimer *pollTimer = nullptr;
+    QTimer *spotRetentionTimer = nullptr;
+    QTimer *spotFilterSaveTimer = nullptr;
     int cwSpeedWpm = 30;
     bool lsbSelected = true;
     bool fmSelected = true;
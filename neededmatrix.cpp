@@ -0,0 +1,84 @@
+#include "neededmatrix.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+namespace {
+
+const char *const kColumnNames[NeededMatrix::ColumnCount] = {
+    "Mix", "Ph", "CW", "RT", "SAT",
+    "160", "80", "40", "30", "20", "17", "15", "12", "10", "6", "2"
+};
+
+}
+
+NeededMatrix::Column NeededMatrix::columnForName(const QString &name)
+{
+    for (int i = 0; i < ColumnCount; ++i) {
+        if (name.compare(QLatin1String(kColumnNames[i]), Qt::CaseInsensitive) == 0) {
+            return Column(i);
+        }
+    }
+    return NoColumn;
+}
+
+bool NeededMatrix::load(QSqlDatabase db)
+{
+    QStringList columns;
+    for (const char *name : kColumnNames) {
+        columns.append(QString("COALESCE(\"%1\", '')").arg(QLatin1String(name)));
+    }
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec(QString("SELECT dxcc, %1 FROM dxcc").arg(columns.join(", ")))) {
+        qWarning() << "Failed to load needed matrix:" << query.lastError();
+        return false;
+    }
+
+    std::array<quint32, kMaxDxcc> words{};
+    while (query.next()) {
+        const int dxcc = query.value(0).toInt();
+        if (dxcc <= 0 || dxcc >= kMaxDxcc) {
+            continue;
+        }
+        quint32 word = kPresent;
+        for (int i = 0; i < ColumnCount; ++i) {
+            if (!query.value(i + 1).toString().trimmed().isEmpty()) {
+                word |= 1u << i;
+            }
+        }
+        words[dxcc] |= word;
+    }
+    for (int i = 0; i < kMaxDxcc; ++i) {
+        m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void NeededMatrix::mark(int dxcc, Column column)
+{
+    if (dxcc <= 0 || dxcc >= kMaxDxcc || column >= ColumnCount) {
+        return;
+    }
+    m_words[dxcc].fetch_or(kPresent | (1u << column), std::memory_order_relaxed);
+}
+
+quint32 NeededMatrix::word(int dxcc) const
+{
+    if (dxcc <= 0 || dxcc >= kMaxDxcc) {
+        return 0;
+    }
+    return m_words[dxcc].load(std::memory_order_relaxed);
+}
+
+bool NeededMatrix::contains(int dxcc) const
+{
+    return (word(dxcc) & kPresent) != 0;
+}
+
+bool NeededMatrix::isMarked(int dxcc, Column column) const
+{
+    return column < ColumnCount && (word(dxcc) & (1u << column)) != 0;
+}
@@ -0,0 +1,52 @@
+#ifndef NEEDEDMATRIX_H
+#define NEEDEDMATRIX_H
+
+#include <QSqlDatabase>
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+// Worked/confirmed state of the dxcc table as one bit word per ADIF entity
+// code, so deciding whether a spot is needed costs a few bit operations
+// instead of a query. Loaded once from the table and then updated alongside
+// every write to it. Writes come from the GUI thread; reads are lock-free
+// from any thread.
+class NeededMatrix
+{
+public:
+    // dxcc table columns, one bit each.
+    enum Column : quint8 {
+        Mix, Phone, Cw, Data, Sat,
+        Band160, Band80, Band40, Band30, Band20, Band17, Band15, Band12, Band10, Band6, Band2,
+        ColumnCount,
+        NoColumn = ColumnCount
+    };
+
+    static constexpr int kMaxDxcc = 1024;
+
+    NeededMatrix() = default;
+    NeededMatrix(const NeededMatrix &) = delete;
+    NeededMatrix &operator=(const NeededMatrix &) = delete;
+
+    // Column by its dxcc table name: "Mix", "Ph", ..., "160", ..., "2".
+    static Column columnForName(const QString &name);
+
+    bool load(QSqlDatabase db = QSqlDatabase::database());
+
+    // Records a non-empty cell written to the dxcc table.
+    void mark(int dxcc, Column column);
+
+    // Whether the dxcc table has a row for the entity.
+    bool contains(int dxcc) const;
+    bool isMarked(int dxcc, Column column) const;
+
+private:
+    static constexpr quint32 kPresent = 0x80000000u;
+
+    quint32 word(int dxcc) const;
+
+    std::array<std::atomic<quint32>, kMaxDxcc> m_words{};
+};
+
+#endif // NEEDEDMATRIX_H
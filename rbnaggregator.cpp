@@ -0,0 +1,152 @@
+#include "rbnaggregator.h"
+
+#include <algorithm>
+
+namespace {
+
+template <typename T>
+T median(QVector<T> values)
+{
+    if (values.isEmpty()) {
+        return T();
+    }
+    const auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+}
+
+RbnAggregator::RbnAggregator(qint64 windowMs, qint64 toleranceHz, qint64 settleMs, int minSkimmers)
+    : m_windowMs(windowMs)
+    , m_toleranceHz(toleranceHz)
+    , m_settleMs(settleMs)
+    , m_minSkimmers(minSkimmers)
+{
+}
+
+int RbnAggregator::size() const
+{
+    int count = 0;
+    for (const QVector<Entry> &entries : m_entries) {
+        count += entries.size();
+    }
+    return count;
+}
+
+void RbnAggregator::add(const RbnSpot &spot, const QString &continent, qint64 nowMs)
+{
+    // The nearest signal of the call within tolerance, so reports either
+    // side of a kHz boundary still merge.
+    QVector<Entry> &entries = m_entries[spot.call];
+    Entry *match = nullptr;
+    for (Entry &candidate : entries) {
+        const qint64 offset = qAbs(candidate.hz - spot.hz);
+        if (offset <= m_toleranceHz && (!match || offset < qAbs(match->hz - spot.hz))) {
+            match = &candidate;
+        }
+    }
+    if (!match) {
+        entries.append(Entry());
+        match = &entries.last();
+        match->hz = spot.hz;
+        match->firstSeenMs = nowMs;
+    }
+    Entry &entry = *match;
+    entry.mode = spot.mode;
+    entry.dirty = true;
+
+    Report report;
+    report.spotter = spot.spotter;
+    report.continent = continent;
+    report.hz = spot.hz;
+    report.ms = nowMs;
+    report.snr = spot.snr;
+    report.speed = spot.speed;
+
+    // A skimmer that reports again replaces its earlier report.
+    for (Report &existing : entry.reports) {
+        if (existing.spotter == spot.spotter) {
+            existing = report;
+            return;
+        }
+    }
+    entry.reports.append(report);
+}
+
+QVector<RbnAggregate> RbnAggregator::takeUpdates(qint64 nowMs)
+{
+    QVector<RbnAggregate> updates;
+    const qint64 cutoff = nowMs - m_windowMs;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        QVector<Entry> &entries = it.value();
+        for (Entry &entry : entries) {
+            entry.reports.erase(std::remove_if(entry.reports.begin(), entry.reports.end(),
+                                               [cutoff](const Report &r) { return r.ms <= cutoff; }),
+                                entry.reports.end());
+        }
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [](const Entry &e) { return e.reports.isEmpty(); }),
+                      entries.end());
+        if (entries.isEmpty()) {
+            it = m_entries.erase(it);
+            continue;
+        }
+        for (Entry &entry : entries) {
+            if (isDue(entry, nowMs)) {
+                updates.append(summarize(it.key(), entry));
+                entry.emitted = true;
+                entry.lastEmittedMs = nowMs;
+                entry.dirty = false;
+            }
+        }
+        ++it;
+    }
+    return updates;
+}
+
+bool RbnAggregator::isDue(const Entry &entry, qint64 nowMs) const
+{
+    if (!entry.dirty) {
+        return false;
+    }
+    if (entry.emitted) {
+        return entry.lastEmittedMs <= nowMs - m_windowMs;
+    }
+    // A signal only one skimmer hears still shows, just later.
+    const qint64 age = nowMs - entry.firstSeenMs;
+    return (age >= m_settleMs && entry.reports.size() >= m_minSkimmers) || age >= m_windowMs / 2;
+}
+
+RbnAggregate RbnAggregator::summarize(const QString &call, const Entry &entry)
+{
+    RbnAggregate aggregate;
+    aggregate.call = call;
+    aggregate.mode = entry.mode;
+    aggregate.skimmers = entry.reports.size();
+    aggregate.firstSeenMs = entry.firstSeenMs;
+    aggregate.minSnr = entry.reports.first().snr;
+    aggregate.maxSnr = aggregate.minSnr;
+
+    QVector<qint64> hz;
+    QVector<int> snr;
+    QVector<int> speed;
+    for (const Report &report : entry.reports) {
+        hz.append(report.hz);
+        snr.append(report.snr);
+        if (report.speed > 0) {
+            speed.append(report.speed);
+        }
+        aggregate.minSnr = qMin(aggregate.minSnr, report.snr);
+        aggregate.maxSnr = qMax(aggregate.maxSnr, report.snr);
+        aggregate.lastSeenMs = qMax(aggregate.lastSeenMs, report.ms);
+        if (!report.continent.isEmpty() && !aggregate.continents.contains(report.continent)) {
+            aggregate.continents.append(report.continent);
+        }
+    }
+    aggregate.hz = median(hz);
+    aggregate.medianSnr = median(snr);
+    aggregate.speed = median(speed);
+    aggregate.continents.sort();
+    return aggregate;
+}
@@ -0,0 +1,85 @@
+#ifndef RBNAGGREGATOR_H
+#define RBNAGGREGATOR_H
+
+#include <QHash>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "rbnreceiver.h"
+
+// One signal as heard by every skimmer that reported it within the window.
+struct RbnAggregate
+{
+    QString call;
+    QString mode;
+    qint64 hz = 0;              // median of the reported frequencies
+    int skimmers = 0;
+    int minSnr = 0;
+    int maxSnr = 0;
+    int medianSnr = 0;
+    int speed = 0;              // median WPM/BPS, 0 when not reported
+    qint64 firstSeenMs = 0;     // ms since epoch
+    qint64 lastSeenMs = 0;
+    QStringList continents;     // of the skimmers, sorted
+};
+
+Q_DECLARE_METATYPE(RbnAggregate)
+
+// Merges RBN reports of one call within toleranceHz of a signal's first
+// report, as SpotDeduper matches cluster spots. Each skimmer counts once per
+// signal; its reports fall out after the window. A new signal is first
+// returned by takeUpdates() once it has settled for settleMs with at least
+// minSkimmers skimmers, or after half a window with fewer, so the first
+// update already carries the skimmers that hear it. Later updates come when
+// there are new reports and none was returned within the last window.
+class RbnAggregator
+{
+public:
+    static constexpr qint64 kDefaultWindowMs = 60000;
+    static constexpr qint64 kDefaultToleranceHz = 1000;
+    static constexpr qint64 kDefaultSettleMs = 5000;
+    static constexpr int kDefaultMinSkimmers = 2;
+
+    explicit RbnAggregator(qint64 windowMs = kDefaultWindowMs, qint64 toleranceHz = kDefaultToleranceHz,
+                           qint64 settleMs = kDefaultSettleMs, int minSkimmers = kDefaultMinSkimmers);
+
+    void add(const RbnSpot &spot, const QString &continent, qint64 nowMs);
+    // Also drops reports and keys that fell out of the window.
+    QVector<RbnAggregate> takeUpdates(qint64 nowMs);
+
+    // Signals currently tracked.
+    int size() const;
+    void clear() { m_entries.clear(); }
+
+private:
+    struct Report {
+        QString spotter;
+        QString continent;
+        qint64 hz = 0;
+        qint64 ms = 0;
+        int snr = 0;
+        int speed = 0;
+    };
+    struct Entry {
+        QString mode;
+        qint64 hz = 0;          // of the first report, the one others match
+        QVector<Report> reports;
+        qint64 firstSeenMs = 0;
+        qint64 lastEmittedMs = 0;
+        bool emitted = false;
+        bool dirty = false;
+    };
+
+    bool isDue(const Entry &entry, qint64 nowMs) const;
+    static RbnAggregate summarize(const QString &call, const Entry &entry);
+
+    qint64 m_windowMs;
+    qint64 m_toleranceHz;
+    qint64 m_settleMs;
+    int m_minSkimmers;
+    QHash<QString, QVector<Entry>> m_entries;   // by call
+};
+
+#endif // RBNAGGREGATOR_H
@@ -0,0 +1,212 @@
+#include "rbnreceiver.h"
+
+#include <QDebug>
+#include <QSettings>
+
+namespace {
+
+constexpr char kLoginPrompt[] = "Please enter your call:";
+constexpr int kMaxTrailingTokens = 6;
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\a';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Whitespace-separated tokens of one line, without copying.
+class Tokenizer
+{
+public:
+    Tokenizer(const char *begin, const char *end) : m_p(begin), m_end(end) {}
+
+    QByteArrayView next()
+    {
+        while (m_p < m_end && isSpace(*m_p)) {
+            ++m_p;
+        }
+        const char *start = m_p;
+        while (m_p < m_end && !isSpace(*m_p)) {
+            ++m_p;
+        }
+        return QByteArrayView(start, m_p - start);
+    }
+
+private:
+    const char *m_p;
+    const char *m_end;
+};
+
+bool parseInt(QByteArrayView token, int *value)
+{
+    qsizetype i = 0;
+    const bool negative = !token.isEmpty() && (token.at(0) == '-' || token.at(0) == '+');
+    if (negative) {
+        i = 1;
+    }
+    if (i == token.size() || token.size() - i > 6) {
+        return false;
+    }
+    int result = 0;
+    for (; i < token.size(); ++i) {
+        if (!isDigit(token.at(i))) {
+            return false;
+        }
+        result = result * 10 + (token.at(i) - '0');
+    }
+    *value = token.at(0) == '-' ? -result : result;
+    return true;
+}
+
+// "14025.0" kHz -> 14025000 Hz; up to three decimals.
+bool parseKhz(QByteArrayView token, qint64 *hz)
+{
+    qint64 whole = 0;
+    qint64 fraction = 0;
+    int decimals = -1;
+    for (const char c : token) {
+        if (c == '.' && decimals < 0) {
+            decimals = 0;
+        } else if (isDigit(c) && decimals < 3 && whole < 100000000) {
+            if (decimals < 0) {
+                whole = whole * 10 + (c - '0');
+            } else {
+                fraction = fraction * 10 + (c - '0');
+                ++decimals;
+            }
+        } else if (!isDigit(c)) {
+            return false;
+        }
+    }
+    for (int i = qMax(decimals, 0); i < 3; ++i) {
+        fraction *= 10;
+    }
+    *hz = whole * 1000 + fraction;
+    return *hz > 0;
+}
+
+bool isTime(QByteArrayView token)
+{
+    return token.size() == 5 && isDigit(token.at(0)) && isDigit(token.at(1))
+           && isDigit(token.at(2)) && isDigit(token.at(3)) && token.at(4) == 'Z';
+}
+
+}
+
+RbnServer RbnReceiver::serverFromSettings(QSettings &settings)
+{
+    const RbnServer defaults;
+    RbnServer server;
+    server.host = settings.value("rbn/host", defaults.host).toString().trimmed();
+    server.port = static_cast<quint16>(settings.value("rbn/port", defaults.port).toUInt());
+    server.login = settings.value("rbn/login", defaults.login).toString().trimmed();
+    if (server.host.isEmpty() || server.port == 0 || server.login.isEmpty()) {
+        qWarning() << "Using the default RBN server: rbn/host, rbn/port or rbn/login is empty";
+        return defaults;
+    }
+    return server;
+}
+
+RbnReceiver::RbnReceiver(const QString &host, quint16 port, const QString &login, QObject *parent)
+    : QObject(parent)
+{
+    TelnetSession::Options options;
+    options.host = host;
+    options.port = port;
+    options.login = login.toLatin1();
+    options.loginPrompt = kLoginPrompt;
+    // Skimmers report around the clock; a minute of silence is a dead link.
+    options.idleTimeoutMs = 60000;
+    m_session = new TelnetSession(options, this);
+    connect(m_session, &TelnetSession::lineReceived, this, [this](QByteArrayView line) {
+        RbnSpot spot;
+        if (parseLine(line, &spot)) {
+            emit spotReceived(spot);
+        }
+    });
+}
+
+void RbnReceiver::start()
+{
+    m_session->start();
+}
+
+void RbnReceiver::stop()
+{
+    m_session->stop();
+}
+
+bool RbnReceiver::parseLine(QByteArrayView line, RbnSpot *spot)
+{
+    // DX de <spotter>-#: <kHz> <call> <mode> <snr> dB [<speed> WPM|BPS] <type...> <HHMM>Z
+    if (!line.startsWith("DX de ")) {
+        return false;
+    }
+    const char *begin = line.data() + 6;
+    const char *end = line.data() + line.size();
+    const char *colon = begin;
+    while (colon < end && *colon != ':') {
+        ++colon;
+    }
+    if (colon == end) {
+        return false;
+    }
+    QByteArrayView spotter = Tokenizer(begin, colon).next();
+    const qsizetype dash = spotter.indexOf('-');
+    if (dash >= 0) {
+        spotter = spotter.first(dash);
+    }
+
+    Tokenizer tokens(colon + 1, end);
+    qint64 hz = 0;
+    int snr = 0;
+    if (!parseKhz(tokens.next(), &hz)) {
+        return false;
+    }
+    const QByteArrayView call = tokens.next();
+    const QByteArrayView mode = tokens.next();
+    if (spotter.isEmpty() || call.isEmpty() || mode.isEmpty()
+        || !parseInt(tokens.next(), &snr) || tokens.next() != "dB") {
+        return false;
+    }
+
+    // Speed and type vary by mode; the last token is always the time.
+    QByteArrayView trailing[kMaxTrailingTokens];
+    int count = 0;
+    for (QByteArrayView token = tokens.next(); !token.isEmpty(); token = tokens.next()) {
+        if (count == kMaxTrailingTokens) {
+            return false;
+        }
+        trailing[count++] = token;
+    }
+    if (count == 0 || !isTime(trailing[count - 1])) {
+        return false;
+    }
+    int first = 0;
+    int speed = 0;
+    if (count >= 3 && (trailing[1] == "WPM" || trailing[1] == "BPS") && parseInt(trailing[0], &speed)) {
+        first = 2;
+    }
+
+    QString type;
+    for (int i = first; i < count - 1; ++i) {
+        if (!type.isEmpty()) {
+            type += QLatin1Char(' ');
+        }
+        type += QString::fromLatin1(trailing[i]);
+    }
+
+    spot->spotter = QString::fromLatin1(spotter);
+    spot->call = QString::fromLatin1(call).toUpper();
+    spot->mode = QString::fromLatin1(mode).toUpper();
+    spot->type = type;
+    spot->time = QString::fromLatin1(trailing[count - 1].first(4));
+    spot->hz = hz;
+    spot->snr = snr;
+    spot->speed = speed;
+    return true;
+}
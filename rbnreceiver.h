@@ -0,0 +1,61 @@
+#ifndef RBNRECEIVER_H
+#define RBNRECEIVER_H
+
+#include <QByteArrayView>
+#include <QMetaType>
+#include <QObject>
+#include "telnetsession.h"
+
+class QSettings;
+
+// One Reverse Beacon Network skimmer report.
+struct RbnSpot
+{
+    QString spotter;    // skimmer call, without the "-#" suffix
+    QString call;
+    QString mode;       // CW, RTTY, FT8, ...
+    QString type;       // CQ, DX, BEACON, NCDXF B
+    QString time;       // HHMM, UTC
+    qint64 hz = 0;
+    int snr = 0;        // dB
+    int speed = 0;      // WPM for CW, baud for RTTY, 0 when not reported
+};
+
+Q_DECLARE_METATYPE(RbnSpot)
+
+// Where the RBN feed is read from.
+struct RbnServer
+{
+    QString host = "telnet.reversebeacon.net";
+    quint16 port = 7000;
+    QString login = "OG3Z";
+};
+
+// Client for the RBN telnet feed, e.g.
+// "DX de OH6BG-#:    14025.0  OG3Z         CW    12 dB  25 WPM  CQ      1234Z".
+// Logs in with the given call when prompted and emits every well-formed
+// line as a structured spot.
+class RbnReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RbnReceiver(const QString &host, quint16 port, const QString &login, QObject *parent = nullptr);
+
+    // rbn/host, rbn/port and rbn/login; RbnServer's values where missing.
+    static RbnServer serverFromSettings(QSettings &settings);
+
+    void start();
+    void stop();
+
+    // Splits one line with a hand-written tokenizer; false if it is not a
+    // spot line.
+    static bool parseLine(QByteArrayView line, RbnSpot *spot);
+
+signals:
+    void spotReceived(const RbnSpot &spot);
+
+private:
+    TelnetSession *m_session = nullptr;
+};
+
+#endif // RBNRECEIVER_H
@@ -0,0 +1,142 @@
+#include "spotdeduper.h"
+
+#include <QHash>
+
+namespace {
+
+constexpr int kInitialCapacity = 256;
+
+}
+
+SpotDeduper::SpotDeduper(qint64 windowMs, qint64 toleranceHz)
+    : m_windowMs(windowMs)
+    , m_toleranceHz(toleranceHz)
+    , m_slots(kInitialCapacity)
+{
+}
+
+quint32 SpotDeduper::hashOf(const QString &call, Band band)
+{
+    return quint32(qHash(call)) ^ (quint32(band) * 0x9e3779b9u);
+}
+
+bool SpotDeduper::isBetter(const DxSpot &spot, const DxSpot &than)
+{
+    const bool known = !spot.mode.isEmpty() && spot.mode != "??";
+    const bool thanKnown = !than.mode.isEmpty() && than.mode != "??";
+    return known && !thanKnown;
+}
+
+int SpotDeduper::findSlot(quint32 hash, const QString &call, Band band, qint64 hz, qint64 nowMs) const
+{
+    // Expired slots stay in the chain so later entries remain reachable.
+    const int mask = m_slots.size() - 1;
+    for (int i = int(hash) & mask; m_slots[i].used; i = (i + 1) & mask) {
+        const Slot &slot = m_slots[i];
+        if (slot.hash == hash && slot.band == band && qAbs(slot.hz - hz) <= m_toleranceHz
+            && isLive(slot, nowMs) && slot.best.call == call) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool SpotDeduper::offer(const DxSpot &spot, qint64 nowMs, int source, Origin *origin)
+{
+    const qint64 hz = frequencyHz(spot.freq);
+    const Band band = bandForHz(hz);
+    const quint32 hash = hashOf(spot.call, band);
+
+    const int found = findSlot(hash, spot.call, band, hz, nowMs);
+    if (found >= 0) {
+        Slot &slot = m_slots[found];
+        if (origin) {
+            *origin = slot.origin;
+        }
+        const bool better = isBetter(spot, slot.best);
+        if (!isBetter(slot.best, spot)) {
+            slot.best = spot;
+        }
+        if (better) {
+            return true;
+        }
+        ++m_suppressed;
+        return false;
+    }
+
+    if ((m_used + 1) * 2 > m_slots.size()) {
+        rehash(nowMs);
+    }
+    const int mask = m_slots.size() - 1;
+    int i = int(hash) & mask;
+    while (m_slots[i].used && isLive(m_slots[i], nowMs)) {
+        i = (i + 1) & mask;
+    }
+    Slot &slot = m_slots[i];
+    if (!slot.used) {
+        ++m_used;
+    }
+    slot = Slot();
+    slot.best = spot;
+    slot.hash = hash;
+    slot.band = band;
+    slot.hz = hz;
+    slot.origin.passedMs = nowMs;
+    slot.origin.source = source;
+    slot.used = true;
+    if (origin) {
+        *origin = slot.origin;
+    }
+    return true;
+}
+
+const DxSpot *SpotDeduper::find(const QString &call, qint64 hz, qint64 nowMs) const
+{
+    const Band band = bandForHz(hz);
+    const int found = findSlot(hashOf(call, band), call, band, hz, nowMs);
+    return found >= 0 ? &m_slots[found].best : nullptr;
+}
+
+int SpotDeduper::size(qint64 nowMs) const
+{
+    int live = 0;
+    for (const Slot &slot : m_slots) {
+        if (isLive(slot, nowMs)) {
+            ++live;
+        }
+    }
+    return live;
+}
+
+void SpotDeduper::clear()
+{
+    m_slots = QVector<Slot>(kInitialCapacity);
+    m_used = 0;
+    m_suppressed = 0;
+}
+
+void SpotDeduper::rehash(qint64 nowMs)
+{
+    // Drop expired slots; grow only if live ones would still fill a quarter.
+    const int live = size(nowMs);
+    int capacity = kInitialCapacity;
+    while (capacity < live * 4) {
+        capacity *= 2;
+    }
+
+    QVector<Slot> old(capacity);
+    old.swap(m_slots);
+    m_used = 0;
+    const int mask = capacity - 1;
+    for (Slot &slot : old) {
+        if (!isLive(slot, nowMs)) {
+            continue;
+        }
+        int i = int(slot.hash) & mask;
+        while (m_slots[i].used) {
+            i = (i + 1) & mask;
+        }
+        m_slots[i] = std::move(slot);
+        ++m_used;
+    }
+}
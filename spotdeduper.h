@@ -0,0 +1,66 @@
+#ifndef SPOTDEDUPER_H
+#define SPOTDEDUPER_H
+
+#include <QString>
+#include <QVector>
+
+#include "bandplan.h"
+#include "dxspot.h"
+
+// Drops re-spots of the same signal: same call on the same band within
+// toleranceHz of a spot passed less than windowMs ago. Slots live in one
+// open-addressing table probed linearly from a hash of call and band;
+// expired slots are reused in place and swept out when the table grows.
+// Not thread-safe; one instance per feed thread.
+class SpotDeduper
+{
+public:
+    static constexpr qint64 kDefaultWindowMs = 10 * 60 * 1000;
+    static constexpr qint64 kDefaultToleranceHz = 1000;
+
+    // Where a signal was first passed on.
+    struct Origin {
+        qint64 passedMs = 0;
+        int source = 0;
+    };
+
+    explicit SpotDeduper(qint64 windowMs = kDefaultWindowMs, qint64 toleranceHz = kDefaultToleranceHz);
+
+    // True if the spot should be passed on: a new signal, or a re-spot that
+    // names the mode the first one lacked. Either way the slot keeps the
+    // most recent spot unless it is worse than the one kept. source tags
+    // the feed; origin, if given, receives the signal's first passing.
+    bool offer(const DxSpot &spot, qint64 nowMs, int source = 0, Origin *origin = nullptr);
+
+    // The kept spot for a signal, or nullptr if none is live.
+    const DxSpot *find(const QString &call, qint64 hz, qint64 nowMs) const;
+
+    // Live signals, and re-spots dropped since construction.
+    int size(qint64 nowMs) const;
+    quint64 suppressed() const { return m_suppressed; }
+    void clear();
+
+private:
+    struct Slot {
+        DxSpot best;
+        quint32 hash = 0;
+        Band band = Band::None;
+        qint64 hz = 0;
+        Origin origin;
+        bool used = false;
+    };
+
+    static quint32 hashOf(const QString &call, Band band);
+    static bool isBetter(const DxSpot &spot, const DxSpot &than);
+    bool isLive(const Slot &slot, qint64 nowMs) const { return slot.used && nowMs - slot.origin.passedMs < m_windowMs; }
+    int findSlot(quint32 hash, const QString &call, Band band, qint64 hz, qint64 nowMs) const;
+    void rehash(qint64 nowMs);
+
+    qint64 m_windowMs;
+    qint64 m_toleranceHz;
+    QVector<Slot> m_slots;
+    int m_used = 0;         // slots filled since the last rehash, live or not
+    quint64 m_suppressed = 0;
+};
+
+#endif // SPOTDEDUPER_H
@@ -0,0 +1,113 @@
+#include "spotfeeds.h"
+#include "bandplan.h"
+#include "callsign.h"
+#include "clusterpool.h"
+#include "country.h"
+#include "neededmatrix.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QSettings>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+
+constexpr char kConnectionName[] = "spotfeeds";
+
+}
+
+SpotFeeds::SpotFeeds(const NeededMatrix *needed, QObject *parent)
+    : QObject(parent)
+    , m_needed(needed)
+    , m_flushTimer(this)
+{
+    qRegisterMetaType<DxSpot>();
+    qRegisterMetaType<QVector<DxSpot>>();
+    qRegisterMetaType<RbnSpot>();
+    qRegisterMetaType<RbnAggregate>();
+}
+
+SpotFeeds::~SpotFeeds()
+{
+    if (QSqlDatabase::contains(kConnectionName)) {
+        QSqlDatabase::database(kConnectionName, false).close();
+        QSqlDatabase::removeDatabase(kConnectionName);
+    }
+}
+
+void SpotFeeds::start()
+{
+    // SQLite connections belong to the thread that opened them.
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::defaultConnection, kConnectionName);
+    if (!db.open()) {
+        qWarning() << "Spot feed database open failed:" << db.lastError();
+    }
+
+    m_flushTimer.setInterval(kFlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &SpotFeeds::flush);
+    m_flushTimer.start();
+
+    QSettings settings;
+    m_cluster = new ClusterPool(ClusterPool::nodesFromSettings(settings), &m_deduper, this);
+    m_cluster->setMaxActive(settings.value("cluster/maxActive", ClusterPool::kDefaultMaxActive).toInt());
+    m_cluster->setNeededMatrix(m_needed);
+    connect(m_cluster, &ClusterPool::spotReceived, this, [this](const DxSpot &spot) {
+        m_pendingSpots.append(spot);
+    });
+    m_cluster->start();
+
+    const RbnServer rbn = RbnReceiver::serverFromSettings(settings);
+    m_rbn = new RbnReceiver(rbn.host, rbn.port, rbn.login, this);
+    connect(m_rbn, &RbnReceiver::spotReceived, this, &SpotFeeds::onRbnSpot);
+    m_rbn->start();
+}
+
+void SpotFeeds::onRbnSpot(const RbnSpot &spot)
+{
+    if (m_rbnPaused || spot.mode != "CW") {
+        return;
+    }
+    const QString continent = Country::shared()->lookup(spot.spotter).continent;
+    m_rbnAggregator.add(spot, continent, QDateTime::currentMSecsSinceEpoch());
+}
+
+bool SpotFeeds::isRbnNeeded(const RbnAggregate &spot) const
+{
+    const QString band = bandName(bandForHz(spot.hz));
+    if (band.isEmpty()) {
+        return false;
+    }
+
+    QSqlQuery q(QSqlDatabase::database(kConnectionName, false));
+    // WWA stations are listed by base call; OH2WWA/P still matches.
+    const QString sql = QString(R"(SELECT "%1" FROM modes WHERE callsign = ? LIMIT 1)").arg(band);
+    q.prepare(sql);
+    q.addBindValue(QString(Callsign(spot.call).base()));
+    if (!q.exec()) {
+        qWarning() << "RBN DB lookup failed:" << q.lastError();
+        return false;
+    }
+    return q.next() && !(q.value(0).toInt() & (1 << 0));
+}
+
+void SpotFeeds::flush()
+{
+    if (!m_pendingSpots.isEmpty()) {
+        emit clusterSpots(m_pendingSpots);
+        m_pendingSpots.clear();
+    }
+
+    // Newest needed signal wins, as the labels only show one.
+    const QVector<RbnAggregate> updates = m_rbnAggregator.takeUpdates(QDateTime::currentMSecsSinceEpoch());
+    const RbnAggregate *latest = nullptr;
+    for (const RbnAggregate &update : updates) {
+        if ((!latest || update.lastSeenMs > latest->lastSeenMs) && isRbnNeeded(update)) {
+            latest = &update;
+        }
+    }
+    if (latest && !m_rbnPaused) {
+        emit rbnSpot(*latest);
+    }
+}
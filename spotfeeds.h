@@ -0,0 +1,60 @@
+#ifndef SPOTFEEDS_H
+#define SPOTFEEDS_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <atomic>
+
+#include "dxspot.h"
+#include "rbnaggregator.h"
+#include "rbnreceiver.h"
+#include "spotdeduper.h"
+
+class ClusterPool;
+class NeededMatrix;
+
+// The DX cluster pool and RBN client, run on a dedicated I/O thread so
+// parsing, country resolution and database lookups stay off the GUI thread.
+// Move the object to its thread and call start() there. Results are
+// collected and delivered in batches at most every kFlushIntervalMs, however
+// fast spots arrive; a signal already delivered by any node is dropped.
+class SpotFeeds : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int kFlushIntervalMs = 250;
+
+    explicit SpotFeeds(const NeededMatrix *needed, QObject *parent = nullptr);
+    ~SpotFeeds() override;
+
+    // While paused, RBN spots are read and dropped. Safe from any thread.
+    void setRbnPaused(bool paused) { m_rbnPaused = paused; }
+
+public slots:
+    void start();
+
+signals:
+    void clusterSpots(const QVector<DxSpot> &spots);
+    // Latest CW RBN signal of a WWA station not yet worked on its band,
+    // merged over all skimmers that heard it.
+    void rbnSpot(const RbnAggregate &spot);
+
+private:
+    void onRbnSpot(const RbnSpot &spot);
+    bool isRbnNeeded(const RbnAggregate &spot) const;
+    void flush();
+
+    const NeededMatrix *m_needed = nullptr;
+    ClusterPool *m_cluster = nullptr;
+    SpotDeduper m_deduper;
+    RbnReceiver *m_rbn = nullptr;
+    RbnAggregator m_rbnAggregator;
+    std::atomic<bool> m_rbnPaused{false};
+
+    QTimer m_flushTimer;
+    QVector<DxSpot> m_pendingSpots;
+};
+
+#endif // SPOTFEEDS_H
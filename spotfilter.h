@@ -0,0 +1,53 @@
+#ifndef SPOTFILTER_H
+#define SPOTFILTER_H
+
+#include <QtGlobal>
+
+#include "dxspot.h"
+
+// The spot tab's band, mode and spotter continent filter as bitmasks. Each
+// group owns a bit range of a quint32 with one bit per enum value, unknown
+// values included. A spot's mask has exactly one bit set in each group, so
+// it passes when it has no bit in common with the rejected mask.
+namespace SpotFilter {
+
+constexpr int kBandShift = 0;
+constexpr int kModeShift = 16;
+constexpr int kContinentShift = 24;
+
+constexpr quint32 kBands = 0x0000ffffu;
+constexpr quint32 kModes = 0x00ff0000u;
+constexpr quint32 kContinents = 0xff000000u;
+
+static_assert(int(Band::M2) < kModeShift - kBandShift, "bands overflow their bit range");
+static_assert(int(SpotMode::Sat) < kContinentShift - kModeShift, "modes overflow their bit range");
+static_assert(int(Continent::Sa) < 32 - kContinentShift, "continents overflow their bit range");
+
+constexpr quint32 bandBit(Band band)
+{
+    return 1u << (kBandShift + int(band));
+}
+
+constexpr quint32 modeBit(SpotMode mode)
+{
+    return 1u << (kModeShift + int(mode));
+}
+
+constexpr quint32 continentBit(Continent continent)
+{
+    return 1u << (kContinentShift + int(continent));
+}
+
+inline quint32 spotMask(const DxSpot &spot)
+{
+    return bandBit(spot.band) | modeBit(spot.modeGroup) | continentBit(spot.continent);
+}
+
+constexpr bool accepts(quint32 spotMask, quint32 rejected)
+{
+    return (spotMask & rejected) == 0;
+}
+
+} // namespace SpotFilter
+
+#endif // SPOTFILTER_H
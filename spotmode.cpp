@@ -0,0 +1,208 @@
+#include "spotmode.h"
+#include "bandplan.h"
+
+#include <QVector>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+struct Keyword {
+    const char *text;
+    SpotMode mode;
+};
+
+// Matched anywhere in the comment, as cluster users write "FT8", "ft8-12db"
+// or "CQFT8" alike.
+constexpr Keyword kKeywords[] = {
+    {"SAT", SpotMode::Sat},
+    {"CW", SpotMode::Cw},
+    {"RTTY", SpotMode::Data},
+    {"FT8", SpotMode::Data},
+    {"FT4", SpotMode::Data},
+    {"DATA", SpotMode::Data},
+    {"DIGI", SpotMode::Data},
+    {"JS8", SpotMode::Data},
+    {"PSK", SpotMode::Data},
+    {"MFSK", SpotMode::Data},
+    {"OLIVIA", SpotMode::Data},
+    {"JT65", SpotMode::Data},
+    {"JT9", SpotMode::Data},
+    {"Q65", SpotMode::Data},
+    {"MSK144", SpotMode::Data},
+    {"SSTV", SpotMode::Data},
+    {"SSB", SpotMode::Phone},
+    {"PHONE", SpotMode::Phone},
+    {"USB", SpotMode::Phone},
+    {"LSB", SpotMode::Phone},
+};
+
+// Common FT8, FT4 and RTTY dial frequencies. Decoded signals are reported
+// at dial plus audio offset, so each covers the following 3 kHz.
+constexpr qint64 kDigitalDialHz[] = {
+    1837000, 1840000, 3573000, 3575000, 7047500, 7074000,
+    10136000, 10140000, 14074000, 14080000, 18100000, 18104000,
+    21074000, 21140000, 24915000, 24919000, 28074000, 28180000,
+    50313000, 50318000,
+};
+constexpr qint64 kAudioPassbandHz = 3000;
+
+// Aho-Corasick automaton over A-Z and 0-9 with every transition resolved,
+// so a scan is one table step per character. Any other character returns
+// to the root state.
+class KeywordAutomaton
+{
+public:
+    KeywordAutomaton();
+    quint8 scan(QStringView text) const;
+
+private:
+    static constexpr int kSlots = 36;
+
+    struct State {
+        std::array<quint8, kSlots> next{};
+        quint8 fail = 0;
+        quint8 modes = 0;
+    };
+
+    static int slot(char16_t c);
+
+    QVector<State> m_states;
+};
+
+int KeywordAutomaton::slot(char16_t c)
+{
+    if (c >= u'a' && c <= u'z') {
+        return c - u'a';
+    }
+    if (c >= u'A' && c <= u'Z') {
+        return c - u'A';
+    }
+    if (c >= u'0' && c <= u'9') {
+        return 26 + (c - u'0');
+    }
+    return -1;
+}
+
+KeywordAutomaton::KeywordAutomaton()
+{
+    // Trie of the keywords; 0 in next[] means no child, as the root is
+    // never a child.
+    m_states.append(State());
+    for (const Keyword &keyword : kKeywords) {
+        int state = 0;
+        for (const char *p = keyword.text; *p; ++p) {
+            const int s = slot(char16_t(*p));
+            if (m_states.at(state).next[s] == 0) {
+                Q_ASSERT(m_states.size() < 256);
+                m_states[state].next[s] = quint8(m_states.size());
+                m_states.append(State());
+            }
+            state = m_states.at(state).next[s];
+        }
+        m_states[state].modes |= quint8(1u << int(keyword.mode));
+    }
+
+    // Breadth-first, fill in failure links and turn missing children into
+    // the failure state's transition.
+    QVector<int> queue;
+    for (int s = 0; s < kSlots; ++s) {
+        const int child = m_states.at(0).next[s];
+        if (child != 0) {
+            queue.append(child);
+        }
+    }
+    for (int i = 0; i < queue.size(); ++i) {
+        const int state = queue.at(i);
+        const int fail = m_states.at(state).fail;
+        m_states[state].modes |= m_states.at(fail).modes;
+        for (int s = 0; s < kSlots; ++s) {
+            const int child = m_states.at(state).next[s];
+            if (child != 0) {
+                m_states[child].fail = m_states.at(fail).next[s];
+                queue.append(child);
+            } else {
+                m_states[state].next[s] = m_states.at(fail).next[s];
+            }
+        }
+    }
+}
+
+quint8 KeywordAutomaton::scan(QStringView text) const
+{
+    const State *states = m_states.constData();
+    quint8 modes = 0;
+    int state = 0;
+    for (const QChar c : text) {
+        const int s = slot(c.unicode());
+        state = s < 0 ? 0 : states[state].next[s];
+        modes |= states[state].modes;
+    }
+    return modes;
+}
+
+const KeywordAutomaton &keywordAutomaton()
+{
+    static const KeywordAutomaton automaton;
+    return automaton;
+}
+
+}
+
+SpotMode spotModeFromComment(QStringView comment)
+{
+    const quint8 modes = keywordAutomaton().scan(comment);
+    for (const SpotMode mode : {SpotMode::Sat, SpotMode::Cw, SpotMode::Data, SpotMode::Phone}) {
+        if (modes & (1u << int(mode))) {
+            return mode;
+        }
+    }
+    return SpotMode::Unknown;
+}
+
+SpotMode spotModeFromFrequency(qint64 hz)
+{
+    const qint64 *end = std::end(kDigitalDialHz);
+    const qint64 *dial = std::upper_bound(std::begin(kDigitalDialHz), end, hz);
+    if (dial != std::begin(kDigitalDialHz) && hz < *(dial - 1) + kAudioPassbandHz) {
+        return SpotMode::Data;
+    }
+
+    switch (segmentForHz(hz)) {
+    case Segment::Cw: return SpotMode::Cw;
+    case Segment::Digital: return SpotMode::Data;
+    case Segment::Phone: return SpotMode::Phone;
+    case Segment::None: break;
+    }
+    return SpotMode::Unknown;
+}
+
+SpotMode classifySpotMode(QStringView comment, qint64 hz)
+{
+    const SpotMode mode = spotModeFromComment(comment);
+    return mode != SpotMode::Unknown ? mode : spotModeFromFrequency(hz);
+}
+
+QString spotModeName(SpotMode mode)
+{
+    switch (mode) {
+    case SpotMode::Cw: return QStringLiteral("CW");
+    case SpotMode::Data: return QStringLiteral("RT");
+    case SpotMode::Phone: return QStringLiteral("Ph");
+    case SpotMode::Sat: return QStringLiteral("SAT");
+    case SpotMode::Unknown: break;
+    }
+    return QStringLiteral("??");
+}
+
+SpotMode spotModeForName(QStringView name)
+{
+    for (const SpotMode mode : {SpotMode::Cw, SpotMode::Data, SpotMode::Phone, SpotMode::Sat}) {
+        if (name.compare(spotModeName(mode), Qt::CaseInsensitive) == 0) {
+            return mode;
+        }
+    }
+    return SpotMode::Unknown;
+}
@@ -0,0 +1,33 @@
+#ifndef SPOTMODE_H
+#define SPOTMODE_H
+
+#include <QString>
+#include <QStringView>
+
+// Mode group of a spot, as in the dxcc table columns.
+enum class SpotMode : quint8 {
+    Unknown,
+    Cw,
+    Data,
+    Phone,
+    Sat,
+};
+
+// Mode from keywords in a spot comment ("FT8 -12dB", "cq ssb", "via QO-100
+// sat"). All keywords are matched case-insensitively in one pass; when
+// several appear, SAT wins over CW, CW over data modes and data over phone.
+SpotMode spotModeFromComment(QStringView comment);
+
+// Mode implied by the frequency alone: a known digital dial frequency, or
+// else the band-plan segment. Unknown outside the band plan.
+SpotMode spotModeFromFrequency(qint64 hz);
+
+// The comment decides when it names a mode; otherwise the frequency does.
+SpotMode classifySpotMode(QStringView comment, qint64 hz);
+
+// "CW", "RT", "Ph", "SAT", or "??" for Unknown.
+QString spotModeName(SpotMode mode);
+// Inverse of spotModeName(), ignoring case; Unknown for anything else.
+SpotMode spotModeForName(QStringView name);
+
+#endif // SPOTMODE_H
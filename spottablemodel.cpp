@@ -0,0 +1,196 @@
+#include "spottablemodel.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <algorithm>
+
+SpotTableModel::SpotTableModel(int capacity, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_ring(qMax(1, capacity))
+    , m_masks(m_ring.size())
+{
+}
+
+int SpotTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+int SpotTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SpotTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    const DxSpot &s = spot(index.row());
+    switch (index.column()) {
+    case TimeColumn: return s.time;
+    case CallColumn: return s.call;
+    case FreqColumn: return s.freq;
+    case ModeColumn: return s.mode;
+    case CountryColumn: return s.country;
+    case SpotterColumn: return s.spotter;
+    case MessageColumn: return s.message;
+    default: break;
+    }
+    return QVariant();
+}
+
+QVariant SpotTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case TimeColumn: return QStringLiteral("Time");
+    case CallColumn: return QStringLiteral("Call");
+    case FreqColumn: return QStringLiteral("Freq");
+    case ModeColumn: return QStringLiteral("Mode");
+    case CountryColumn: return QStringLiteral("Country");
+    case SpotterColumn: return QStringLiteral("Spotter");
+    case MessageColumn: return QStringLiteral("Message");
+    default: break;
+    }
+    return QVariant();
+}
+
+bool SpotTableModel::load(QSqlDatabase db)
+{
+    QSqlQuery q(db);
+    q.prepare(R"(
+        SELECT time, call, freq, mode, country, spotter, message, dxcc, ts,
+               hz, band, mode_group, continent, rowid
+        FROM spots ORDER BY ts DESC LIMIT ?
+    )");
+    q.addBindValue(capacity());
+    if (!q.exec()) {
+        qWarning() << "Spot load failed:" << q.lastError();
+        return false;
+    }
+
+    QVector<DxSpot> newestFirst;
+    while (q.next()) {
+        DxSpot s;
+        s.time = q.value(0).toString();
+        s.call = q.value(1).toString();
+        s.freq = q.value(2).toString();
+        s.mode = q.value(3).toString();
+        s.country = q.value(4).toString();
+        s.spotter = q.value(5).toString();
+        s.message = q.value(6).toString();
+        s.dxcc = q.value(7).toInt();
+        s.epoch = q.value(8).toLongLong();
+        s.hz = q.value(9).toLongLong();
+        s.band = static_cast<Band>(q.value(10).toInt());
+        s.modeGroup = static_cast<SpotMode>(q.value(11).toInt());
+        s.continent = static_cast<Continent>(q.value(12).toInt());
+        s.id = q.value(13).toLongLong();
+        newestFirst.append(s);
+    }
+
+    beginResetModel();
+    m_head = 0;
+    m_count = newestFirst.size();
+    for (int i = 0; i < m_count; ++i) {
+        put(i, newestFirst.at(m_count - 1 - i));
+    }
+    endResetModel();
+    return true;
+}
+
+void SpotTableModel::addSpots(const QVector<DxSpot> &spots)
+{
+    // Of a batch larger than the buffer, only the newest can be kept.
+    const int first = qMax(0, int(spots.size()) - capacity());
+    const int added = spots.size() - first;
+    if (added == 0) {
+        return;
+    }
+    const int overflow = m_count + added - capacity();
+    if (overflow > 0) {
+        dropOldest(overflow);
+    }
+
+    beginInsertRows(QModelIndex(), 0, added - 1);
+    for (int i = first; i < spots.size(); ++i) {
+        put((m_head + m_count) % capacity(), spots.at(i));
+        ++m_count;
+    }
+    endInsertRows();
+}
+
+int SpotTableModel::expireBefore(qint64 epoch)
+{
+    int expired = 0;
+    while (expired < m_count && m_ring.at((m_head + expired) % capacity()).epoch < epoch) {
+        ++expired;
+    }
+    if (expired > 0) {
+        dropOldest(expired);
+    }
+    return expired;
+}
+
+void SpotTableModel::removeSpotRows(QVector<int> rows)
+{
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    for (const int row : rows) {
+        if (row < 0 || row >= m_count) {
+            continue;
+        }
+        // Newer spots shift down one slot to close the gap.
+        beginRemoveRows(QModelIndex(), row, row);
+        for (int r = row; r > 0; --r) {
+            m_ring[slot(r)] = std::move(m_ring[slot(r - 1)]);
+            m_masks[slot(r)] = m_masks.at(slot(r - 1));
+        }
+        m_ring[slot(0)] = DxSpot();
+        --m_count;
+        endRemoveRows();
+    }
+}
+
+void SpotTableModel::put(int index, const DxSpot &spot)
+{
+    m_ring[index] = spot;
+    m_masks[index] = SpotFilter::spotMask(spot);
+}
+
+void SpotTableModel::dropOldest(int count)
+{
+    beginRemoveRows(QModelIndex(), m_count - count, m_count - 1);
+    for (int i = 0; i < count; ++i) {
+        m_ring[(m_head + i) % capacity()] = DxSpot();
+    }
+    m_head = (m_head + count) % capacity();
+    m_count -= count;
+    endRemoveRows();
+}
+
+SpotFilterModel::SpotFilterModel(SpotTableModel *spots, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_spots(spots)
+{
+    setSourceModel(spots);
+}
+
+void SpotFilterModel::setRejected(quint32 rejected)
+{
+    if (rejected == m_rejected) {
+        return;
+    }
+    m_rejected = rejected;
+    invalidateFilter();
+}
+
+bool SpotFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    return !sourceParent.isValid() && SpotFilter::accepts(m_spots->filterMask(sourceRow), m_rejected);
+}
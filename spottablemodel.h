@@ -0,0 +1,90 @@
+#ifndef SPOTTABLEMODEL_H
+#define SPOTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QSqlDatabase>
+#include <QVector>
+
+#include "dxspot.h"
+#include "spotfilter.h"
+
+// The spot tab's rows, newest first, held in a fixed-capacity ring buffer.
+// New spots enter at the top with beginInsertRows() and old ones leave from
+// the bottom with beginRemoveRows(), so views keep their scroll position and
+// selection and only measure the rows that changed. SQLite is persistence
+// only: load() reads it once at startup.
+class SpotTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        TimeColumn,
+        CallColumn,
+        FreqColumn,
+        ModeColumn,
+        CountryColumn,
+        SpotterColumn,
+        MessageColumn,
+        ColumnCount
+    };
+
+    static constexpr int kDefaultCapacity = 50000;
+
+    explicit SpotTableModel(int capacity = kDefaultCapacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Newest retained spots from the table, replacing the current rows.
+    bool load(QSqlDatabase db = QSqlDatabase::database());
+
+    // Spots in arrival order; the last one becomes row 0. The oldest rows
+    // make room when the buffer is full.
+    void addSpots(const QVector<DxSpot> &spots);
+    // Drops spots received before epoch; returns how many.
+    int expireBefore(qint64 epoch);
+    void removeSpotRows(QVector<int> rows);
+
+    const DxSpot &spot(int row) const { return m_ring.at(slot(row)); }
+    // SpotFilter::spotMask() of the row, computed once on arrival.
+    quint32 filterMask(int row) const { return m_masks.at(slot(row)); }
+    int capacity() const { return m_ring.size(); }
+
+private:
+    // Row 0 is the newest spot, the one just before m_head + m_count.
+    int slot(int row) const { return (m_head + m_count - 1 - row) % m_ring.size(); }
+    void dropOldest(int count);
+    void put(int index, const DxSpot &spot);
+
+    QVector<DxSpot> m_ring;
+    QVector<quint32> m_masks;   // parallel to m_ring
+    int m_head = 0;     // oldest spot
+    int m_count = 0;
+};
+
+// The rows of a SpotTableModel that pass the spot tab's band, mode and
+// spotter continent checkboxes, tested with one AND of the row's filter
+// mask. New source rows are tested as they arrive; only a changed
+// selection re-tests them all.
+class SpotFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit SpotFilterModel(SpotTableModel *spots, QObject *parent = nullptr);
+
+    // SpotFilter bits of the values to hide; 0 shows everything.
+    void setRejected(quint32 rejected);
+    quint32 rejected() const { return m_rejected; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    SpotTableModel *m_spots = nullptr;
+    quint32 m_rejected = 0;
+};
+
+#endif // SPOTTABLEMODEL_H
@@ -0,0 +1,133 @@
+#include "spotwriter.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlError>
+
+#include <utility>
+
+namespace {
+
+// Flushes slower than this are worth a warning.
+constexpr qint64 kSlowFlushUs = 250 * 1000;
+
+}
+
+SpotWriter::SpotWriter(QSqlDatabase db, QObject *parent)
+    : QObject(parent)
+    , m_db(db)
+    , m_insert(db)
+    , m_timer(this)
+{
+    // Started by the first spot queued, so none waits longer than the interval.
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(kDefaultFlushIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &SpotWriter::flush);
+}
+
+SpotWriter::~SpotWriter()
+{
+    flush();
+}
+
+QVector<DxSpot> SpotWriter::enqueue(QVector<DxSpot> spots)
+{
+    if (spots.isEmpty()) {
+        return spots;
+    }
+    assignIds(spots);
+    m_queue += spots;
+    if (m_queue.size() >= m_maxBatch) {
+        flush();
+    } else if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+    return spots;
+}
+
+void SpotWriter::assignIds(QVector<DxSpot> &spots)
+{
+    if (m_nextId == 0) {
+        QSqlQuery q(m_db);
+        if (q.exec("SELECT IFNULL(MAX(rowid), 0) FROM spots") && q.next()) {
+            m_nextId = q.value(0).toLongLong() + 1;
+        } else {
+            // Left to SQLite; such spots cannot be deleted from the view.
+            qWarning() << "Spot rowid lookup failed:" << q.lastError();
+            return;
+        }
+    }
+    for (DxSpot &spot : spots) {
+        spot.id = m_nextId++;
+    }
+}
+
+bool SpotWriter::flush()
+{
+    m_timer.stop();
+    if (m_queue.isEmpty()) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!m_prepared) {
+        m_prepared = m_insert.prepare(R"(
+            INSERT INTO spots (time, call, freq, mode, country, spotter, message, dxcc, ts,
+                               hz, band, mode_group, continent, rowid)
+            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+        )");
+        if (!m_prepared) {
+            qWarning() << "Spot insert prepare failed:" << m_insert.lastError();
+        }
+    }
+    if (!m_prepared || !m_db.transaction()) {
+        qWarning() << "Spot flush failed, keeping" << m_queue.size() << "spots:" << m_db.lastError();
+        return retryLater();
+    }
+
+    for (const DxSpot &spot : std::as_const(m_queue)) {
+        m_insert.bindValue(0, spot.time);
+        m_insert.bindValue(1, spot.call);
+        m_insert.bindValue(2, spot.freq);
+        m_insert.bindValue(3, spot.mode);
+        m_insert.bindValue(4, spot.country);
+        m_insert.bindValue(5, spot.spotter);
+        m_insert.bindValue(6, spot.message);
+        m_insert.bindValue(7, spot.dxcc);
+        m_insert.bindValue(8, spot.epoch);
+        m_insert.bindValue(9, spot.hz);
+        m_insert.bindValue(10, int(spot.band));
+        m_insert.bindValue(11, int(spot.modeGroup));
+        m_insert.bindValue(12, int(spot.continent));
+        m_insert.bindValue(13, spot.id > 0 ? QVariant(spot.id) : QVariant());
+        if (!m_insert.exec()) {
+            qWarning() << "Spot insert failed:" << m_insert.lastError();
+        }
+    }
+    if (!m_db.commit()) {
+        qWarning() << "Spot batch commit failed, keeping" << m_queue.size() << "spots:" << m_db.lastError();
+        m_db.rollback();
+        return retryLater();
+    }
+
+    const int count = m_queue.size();
+    m_queue.clear();
+    m_written += count;
+    m_lastFlushUs = timer.nsecsElapsed() / 1000;
+    m_maxFlushUs = qMax(m_maxFlushUs, m_lastFlushUs);
+    if (m_lastFlushUs > kSlowFlushUs) {
+        qWarning() << "Slow spot flush:" << count << "spots in" << m_lastFlushUs / 1000 << "ms";
+    }
+    emit flushed(count, m_lastFlushUs);
+    return true;
+}
+
+bool SpotWriter::retryLater()
+{
+    if (m_queue.size() > kMaxQueued) {
+        m_queue.remove(0, m_queue.size() - kMaxQueued);
+    }
+    m_timer.start();
+    return false;
+}
@@ -0,0 +1,63 @@
+#ifndef SPOTWRITER_H
+#define SPOTWRITER_H
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTimer>
+#include <QVector>
+
+#include "dxspot.h"
+
+// Write-behind persistence for the spots table. Spots wait in memory and
+// are written in one transaction through a single prepared INSERT, every
+// flushIntervalMs or as soon as maxBatch are waiting, so the commit cost is
+// paid per batch instead of per spot. Whatever is queued is written on
+// flush() and on destruction. Each spot gets its rowid when queued, so the
+// view's copy can be deleted by rowid later.
+class SpotWriter : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int kDefaultFlushIntervalMs = 2000;
+    static constexpr int kDefaultMaxBatch = 500;
+    // Past this, a failing database drops the oldest queued spots.
+    static constexpr int kMaxQueued = 100000;
+
+    explicit SpotWriter(QSqlDatabase db = QSqlDatabase::database(), QObject *parent = nullptr);
+    ~SpotWriter() override;
+
+    void setFlushInterval(int ms) { m_timer.setInterval(qMax(0, ms)); }
+    void setMaxBatch(int count) { m_maxBatch = qMax(1, count); }
+
+    // Returns the spots with DxSpot::id set to the rowid they will have.
+    QVector<DxSpot> enqueue(QVector<DxSpot> spots);
+    // Writes everything queued now; false if the batch was not committed.
+    bool flush();
+
+    int queueDepth() const { return m_queue.size(); }
+    // Wall time of the last flush and of the slowest one so far.
+    qint64 lastFlushUs() const { return m_lastFlushUs; }
+    qint64 maxFlushUs() const { return m_maxFlushUs; }
+    quint64 written() const { return m_written; }
+
+signals:
+    void flushed(int count, qint64 elapsedUs);
+
+private:
+    bool retryLater();
+    void assignIds(QVector<DxSpot> &spots);
+
+    QSqlDatabase m_db;
+    QSqlQuery m_insert;
+    bool m_prepared = false;
+    QVector<DxSpot> m_queue;
+    qint64 m_nextId = 0;    // 0 until read from the table
+    QTimer m_timer;
+    int m_maxBatch = kDefaultMaxBatch;
+    qint64 m_lastFlushUs = 0;
+    qint64 m_maxFlushUs = 0;
+    quint64 m_written = 0;
+};
+
+#endif // SPOTWRITER_H
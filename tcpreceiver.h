@@ -2,17 +2,20 @@
 #define TCPRECEIVER_H
 
 #include <QObject>
-#include <QTcpSocket>
 #include "country.h"
+#include "neededmatrix.h"
+#include "telnetsession.h"
 
 class TcpReceiver : public QObject
 {
     Q_OBJECT
 public:
-    explicit TcpReceiver(const QString &host, quint16 port, QObject *parent = nullptr);
+    explicit TcpReceiver(const QString &host, quint16 port, const QString &login, QObject *parent = nullptr);
 
     void start();
     void stop();
+    // Spots are emitted only for bands the matrix has no entry for yet.
+    void setNeededMatrix(const NeededMatrix *matrix) { m_needed = matrix; }
 
 signals:
     void spotReceived(const QString &time,
@@ -20,22 +23,19 @@ signals:
                       const QString &freq,
                       const QString &mode,
                       const QString &country,
+                      int dxcc,
                       const QString &spotter,
                       const QString &message);
+    void connectionChanged(bool connected);
+    // Every well-formed DX line, before the needed filter.
+    void spotLineReceived();
 
-private slots:
-    void connected();
-    void onReadyRead();
 private:
-    void scheduleReconnect();
+    void onLine(QByteArrayView line);
+    void processLine(const QString &line);
 
-    QString m_host;
-    quint16 m_port = 0;
-    QTcpSocket *m_socket = nullptr;
-    QString m_buffer;
-    Country m_country;
-    bool m_shouldReconnect = false;
-    bool m_reconnectPending = false;
+    TelnetSession *m_session = nullptr;
+    const NeededMatrix *m_needed = nullptr;
 };
 
 #endif // TCPRECEIVER_H
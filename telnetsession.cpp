@@ -0,0 +1,179 @@
+#include "telnetsession.h"
+
+#include <QDebug>
+#include <QRandomGenerator>
+
+TelnetSession::TelnetSession(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_reconnectTimer(this)
+    , m_idleTimer(this)
+{
+    m_socket = new QTcpSocket(this);
+    connect(m_socket, &QTcpSocket::connected, this, &TelnetSession::onConnected);
+    connect(m_socket, &QTcpSocket::disconnected, this, &TelnetSession::onDropped);
+    connect(m_socket, &QTcpSocket::readyRead, this, &TelnetSession::onReadyRead);
+    connect(m_socket,
+            QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred),
+            this, [this](QAbstractSocket::SocketError) {
+                qWarning() << "Telnet error:" << m_options.host << m_options.port << m_socket->errorString();
+                // A failed attempt never emits disconnected().
+                if (m_socket->state() != QAbstractSocket::ConnectedState) {
+                    m_idleTimer.stop();
+                    scheduleReconnect();
+                }
+            });
+
+    m_reconnectTimer.setSingleShot(true);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, &TelnetSession::connectNow);
+    m_idleTimer.setSingleShot(true);
+    connect(&m_idleTimer, &QTimer::timeout, this, &TelnetSession::onIdle);
+}
+
+int TelnetSession::backoffMs(int attempt, int initialMs, int maxMs, double jitter)
+{
+    qint64 step = initialMs;
+    for (int i = 0; i < attempt && step < maxMs; ++i) {
+        step *= 2;
+    }
+    step = qMin<qint64>(step, maxMs);
+    return static_cast<int>(step / 2 + jitter * (step - step / 2));
+}
+
+void TelnetSession::start()
+{
+    m_shouldReconnect = true;
+    if (m_socket->state() == QAbstractSocket::UnconnectedState && !m_reconnectTimer.isActive()) {
+        connectNow();
+    }
+}
+
+void TelnetSession::stop()
+{
+    m_shouldReconnect = false;
+    m_reconnectTimer.stop();
+    m_idleTimer.stop();
+    m_socket->disconnectFromHost();
+}
+
+bool TelnetSession::sendLine(QByteArrayView line)
+{
+    if (queuedBytes() + line.size() + 2 > m_options.maxQueuedBytes) {
+        qWarning() << "Telnet send queue full:" << m_options.host << m_options.port;
+        return false;
+    }
+    m_queue.append(line.data(), line.size());
+    m_queue.append("\r\n");
+    flushQueue();
+    return true;
+}
+
+void TelnetSession::connectNow()
+{
+    if (!m_shouldReconnect || m_socket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+    qDebug() << "Telnet connecting:" << m_options.host << m_options.port;
+    m_socket->connectToHost(m_options.host, m_options.port);
+    m_idleTimer.start(m_options.connectTimeoutMs);
+}
+
+void TelnetSession::onConnected()
+{
+    qDebug() << "Telnet connected:" << m_options.host << m_options.port;
+    m_framer.clear();
+    m_loggedIn = false;
+    m_keepAliveSent = false;
+    m_idleTimer.stop();
+    if (m_options.idleTimeoutMs > 0) {
+        m_idleTimer.start(m_options.keepAlive.isEmpty() ? m_options.idleTimeoutMs : m_options.idleTimeoutMs / 2);
+    }
+    emit connected();
+    if (m_options.loginPrompt.isEmpty()) {
+        sendLogin();
+    }
+}
+
+void TelnetSession::onDropped()
+{
+    qWarning() << "Telnet disconnected:" << m_options.host << m_options.port;
+    m_framer.clear();
+    m_loggedIn = false;
+    m_idleTimer.stop();
+    emit disconnected();
+    scheduleReconnect();
+}
+
+void TelnetSession::onIdle()
+{
+    if (m_socket->state() != QAbstractSocket::ConnectedState) {
+        qWarning() << "Telnet connect timed out:" << m_options.host << m_options.port;
+        m_socket->abort();
+        scheduleReconnect();
+        return;
+    }
+    if (!m_options.keepAlive.isEmpty() && !m_keepAliveSent) {
+        m_socket->write(m_options.keepAlive + "\r\n");
+        m_keepAliveSent = true;
+        m_idleTimer.start(m_options.idleTimeoutMs - m_options.idleTimeoutMs / 2);
+        return;
+    }
+    // Half-open sessions never see a FIN; give up on the silence instead.
+    qWarning() << "Telnet silent for" << m_options.idleTimeoutMs << "ms:" << m_options.host << m_options.port;
+    m_socket->abort();
+    scheduleReconnect();
+}
+
+void TelnetSession::onReadyRead()
+{
+    if (m_framer.readFrom(m_socket) > 0 && m_options.idleTimeoutMs > 0) {
+        m_keepAliveSent = false;
+        m_idleTimer.start(m_options.keepAlive.isEmpty() ? m_options.idleTimeoutMs : m_options.idleTimeoutMs / 2);
+    }
+
+    QByteArrayView line;
+    while (m_framer.next(&line)) {
+        // A session that delivers is healthy again.
+        m_attempt = 0;
+        emit lineReceived(line);
+    }
+
+    // Prompts have no line break; they wait as the partial line.
+    if (!m_loggedIn && !m_options.loginPrompt.isEmpty()) {
+        const QByteArrayView partial = m_framer.partial();
+        if (QByteArray::fromRawData(partial.data(), partial.size()).contains(m_options.loginPrompt)) {
+            sendLogin();
+        }
+    }
+}
+
+void TelnetSession::sendLogin()
+{
+    if (!m_options.login.isEmpty()) {
+        m_socket->write(m_options.login + "\r\n");
+        qDebug() << "Telnet login sent:" << m_options.host << m_options.port;
+    }
+    m_loggedIn = true;
+    flushQueue();
+}
+
+void TelnetSession::flushQueue()
+{
+    if (!m_loggedIn || m_queue.isEmpty() || !isConnected()) {
+        return;
+    }
+    m_socket->write(m_queue);
+    m_queue.clear();
+}
+
+void TelnetSession::scheduleReconnect()
+{
+    if (!m_shouldReconnect || m_reconnectTimer.isActive()) {
+        return;
+    }
+    const int delay = backoffMs(m_attempt, m_options.initialBackoffMs, m_options.maxBackoffMs,
+                                QRandomGenerator::global()->generateDouble());
+    ++m_attempt;
+    qDebug() << "Telnet reconnecting in" << delay << "ms:" << m_options.host << m_options.port;
+    m_reconnectTimer.start(delay);
+}
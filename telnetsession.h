@@ -0,0 +1,78 @@
+#ifndef TELNETSESSION_H
+#define TELNETSESSION_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "lineframer.h"
+
+// A line-based telnet client session that stays up on its own: it logs in,
+// frames input into lines, reconnects with jittered exponential backoff
+// after any drop or failed attempt, and treats a connection that has been
+// silent for idleTimeoutMs as dead. Outgoing lines wait in a bounded queue
+// until the session is logged in.
+class TelnetSession : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options {
+        QString host;
+        quint16 port = 0;
+        QByteArray login;               // sent once per connection
+        QByteArray loginPrompt;         // wait for it; empty sends on connect
+        QByteArray keepAlive;           // sent at half the idle timeout; empty for none
+        int initialBackoffMs = 1000;
+        int maxBackoffMs = 120000;
+        int connectTimeoutMs = 15000;
+        int idleTimeoutMs = 300000;     // 0 never gives up on a quiet peer
+        int maxQueuedBytes = 16384;
+    };
+
+    explicit TelnetSession(const Options &options, QObject *parent = nullptr);
+
+    void start();
+    void stop();
+    bool isConnected() const { return m_socket->state() == QAbstractSocket::ConnectedState; }
+
+    // Queues one line; false, and nothing queued, if the queue is full.
+    bool sendLine(QByteArrayView line);
+    qsizetype queuedBytes() const { return m_queue.size() + m_socket->bytesToWrite(); }
+
+    // Delay before reconnect attempt number attempt (0-based): the capped
+    // exponential step, with its upper half replaced by jitter in [0, 1].
+    static int backoffMs(int attempt, int initialMs, int maxMs, double jitter);
+
+signals:
+    void connected();
+    void disconnected();
+    // The view is only valid during the emission; connect directly.
+    void lineReceived(QByteArrayView line);
+
+private slots:
+    void onReadyRead();
+
+private:
+    void connectNow();
+    void onConnected();
+    void onDropped();
+    void onIdle();
+    void sendLogin();
+    void flushQueue();
+    void scheduleReconnect();
+
+    Options m_options;
+    QTcpSocket *m_socket = nullptr;
+    LineFramer m_framer;
+    QByteArray m_queue;
+    QTimer m_reconnectTimer;
+    QTimer m_idleTimer;
+    int m_attempt = 0;
+    bool m_loggedIn = false;
+    bool m_keepAliveSent = false;
+    bool m_shouldReconnect = false;
+};
+
+#endif // TELNETSESSION_H
@@ -0,0 +1,136 @@
+#include <QtTest/QtTest>
+
+#include "bandplan.h"
+
+class BandPlanTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void matchesLegacyRanges();
+    void segmentsCoverEveryBand();
+    void parsesNamesAndFrequencies();
+    void benchmarkLegacyChain();
+    void benchmarkBandForHz();
+};
+
+QObject *createBandPlanTest()
+{
+    return new BandPlanTest();
+}
+
+// The floating-point chain TcpReceiver used before the band plan.
+static QString legacyBand(double mhz)
+{
+    if (mhz >= 1.8 && mhz < 2.0) return "160";
+    if (mhz >= 3.5 && mhz < 4.0) return "80";
+    if (mhz >= 7.0 && mhz < 7.3) return "40";
+    if (mhz >= 10.1 && mhz < 10.15) return "30";
+    if (mhz >= 14.0 && mhz < 14.35) return "20";
+    if (mhz >= 18.068 && mhz < 18.168) return "17";
+    if (mhz >= 21.0 && mhz < 21.45) return "15";
+    if (mhz >= 24.89 && mhz < 24.99) return "12";
+    if (mhz >= 28.0 && mhz < 29.7) return "10";
+    if (mhz >= 50.0 && mhz < 54.0) return "6";
+    if (mhz >= 144.0 && mhz < 148.0) return "2";
+    return QString();
+}
+
+// Every 100 Hz step up to 150 MHz, plus both sides of every edge.
+void BandPlanTest::matchesLegacyRanges()
+{
+    for (qint64 hz = 0; hz <= 150000000; hz += 100) {
+        const QString expected = legacyBand(hz / 1e6);
+        if (bandName(bandForHz(hz)) != expected) {
+            QFAIL(qPrintable(QString("%1 Hz: expected band \"%2\", got \"%3\"")
+                                 .arg(hz).arg(expected, bandName(bandForHz(hz)))));
+        }
+    }
+    for (const BandSegment &segment : kSegments) {
+        for (const qint64 hz : {segment.startHz - 1, segment.startHz}) {
+            QCOMPARE(bandName(bandForHz(hz)), legacyBand(hz / 1e6));
+        }
+    }
+}
+
+void BandPlanTest::segmentsCoverEveryBand()
+{
+    for (int i = 1; i <= kBandCount; ++i) {
+        const Band band = Band(i);
+        const qint64 low = bandLowHz(band);
+        const qint64 high = bandHighHz(band);
+        QVERIFY(low > 0);
+        QVERIFY(high > low);
+        QCOMPARE(bandForHz(low - 1), Band::None);
+        QCOMPARE(bandForHz(low), band);
+        QCOMPARE(bandForHz(high - 1), band);
+        QCOMPARE(bandForHz(high), Band::None);
+        QCOMPARE(segmentForHz(low), Segment::Cw);
+        for (qint64 hz = low; hz < high; hz += 500) {
+            QVERIFY(segmentForHz(hz) != Segment::None);
+        }
+    }
+    QCOMPARE(segmentForHz(14025000), Segment::Cw);
+    QCOMPARE(segmentForHz(14074000), Segment::Digital);
+    QCOMPARE(segmentForHz(14200000), Segment::Phone);
+    QCOMPARE(segmentForHz(50313000), Segment::Digital);
+    QCOMPARE(segmentForHz(50150000), Segment::Phone);
+    QCOMPARE(segmentForHz(10136000), Segment::Digital);
+    QCOMPARE(bandForHz(-1), Band::None);
+    QCOMPARE(bandForHz(1000000000), Band::None);
+}
+
+void BandPlanTest::parsesNamesAndFrequencies()
+{
+    QCOMPARE(bandForName(u"160"), Band::M160);
+    QCOMPARE(bandForName(u" 20m "), Band::M20);
+    QCOMPARE(bandForName(u"6M"), Band::M6);
+    QCOMPARE(bandForName(u"60"), Band::None);
+    QCOMPARE(bandForName(u""), Band::None);
+    QCOMPARE(bandName(Band::M2), QString("2"));
+    QCOMPARE(bandName(Band::None), QString());
+
+    QCOMPARE(frequencyHz(u"14024.8"), qint64(14024800));
+    QCOMPARE(frequencyHz(u"  7074.0 "), qint64(7074000));
+    QCOMPARE(frequencyHz(u"14.074"), qint64(14074000));
+    QCOMPARE(frequencyHz(u"144174.0"), qint64(144174000));
+    QCOMPARE(frequencyHz(u"abc"), qint64(0));
+    QCOMPARE(frequencyHz(u"-7.0"), qint64(0));
+}
+
+static QVector<qint64> spotFrequencies()
+{
+    QVector<qint64> hz;
+    hz.reserve(100000);
+    quint32 seed = 12345;
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        hz.append(qint64(seed % 150000000u));
+    }
+    return hz;
+}
+
+void BandPlanTest::benchmarkLegacyChain()
+{
+    const QVector<qint64> frequencies = spotFrequencies();
+    int found = 0;
+    QBENCHMARK {
+        for (const qint64 hz : frequencies) {
+            found += legacyBand(hz / 1e6).isEmpty() ? 0 : 1;
+        }
+    }
+    QVERIFY(found >= 0);
+}
+
+void BandPlanTest::benchmarkBandForHz()
+{
+    const QVector<qint64> frequencies = spotFrequencies();
+    int found = 0;
+    QBENCHMARK {
+        for (const qint64 hz : frequencies) {
+            found += bandForHz(hz) != Band::None ? 1 : 0;
+        }
+    }
+    QVERIFY(found >= 0);
+}
+
+#include "bandplan_test.moc"
@@ -0,0 +1,151 @@
+#include <QtTest/QtTest>
+#include <QThread>
+
+#include "callcache.h"
+#include "country.h"
+
+class CallCacheTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void hitsAndMisses();
+    void evictsWithSecondChance();
+    void countryReloadClearsCache();
+    void neverBlocksUnderContention();
+};
+
+QObject *createCallCacheTest()
+{
+    return new CallCacheTest();
+}
+
+void CallCacheTest::hitsAndMisses()
+{
+    CallCache cache(8, 1);
+    int value = 0;
+    QVERIFY(!cache.find("OG3Z", &value));
+    cache.insert("OG3Z", 42);
+    cache.insert("N0CALL", -1);
+    QVERIFY(cache.find("OG3Z", &value));
+    QCOMPARE(value, 42);
+    QVERIFY(cache.find("N0CALL", &value));
+    QCOMPARE(value, -1);
+
+    const CallCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, quint64(2));
+    QCOMPARE(stats.misses, quint64(1));
+    QCOMPARE(stats.evictions, quint64(0));
+    QCOMPARE(stats.size, 2);
+}
+
+void CallCacheTest::evictsWithSecondChance()
+{
+    CallCache cache(2, 1);
+    cache.insert("A1A", 1);
+    cache.insert("B1B", 2);
+    QVERIFY(cache.find("A1A", nullptr));
+
+    // B1B was not referenced since insertion, so it goes first.
+    cache.insert("C1C", 3);
+    QVERIFY(cache.find("A1A", nullptr));
+    QVERIFY(!cache.find("B1B", nullptr));
+    QVERIFY(cache.find("C1C", nullptr));
+    QCOMPARE(cache.stats().evictions, quint64(1));
+    QCOMPARE(cache.stats().size, 2);
+}
+
+void CallCacheTest::countryReloadClearsCache()
+{
+    const QString data =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH,OI,OJ;";
+    Country country;
+    country.ParseCty(data);
+    QCOMPARE(country.GetCountry("OG3Z"), QString("Finland"));
+    QCOMPARE(country.GetCountry("OG3Z"), QString("Finland"));
+    QCOMPARE(country.cacheStats().hits, quint64(1));
+    QCOMPARE(country.cacheStats().size, 1);
+
+    // Case variants of a call share its slot.
+    QCOMPARE(country.GetCountry("og3z"), QString("Finland"));
+    QCOMPARE(country.GetCountry("Og3z"), QString("Finland"));
+    QCOMPARE(country.cacheStats().hits, quint64(3));
+    QCOMPARE(country.cacheStats().misses, quint64(1));
+    QCOMPARE(country.cacheStats().size, 1);
+
+    country.ParseCty(data);
+    QCOMPARE(country.cacheStats().size, 0);
+}
+
+void CallCacheTest::neverBlocksUnderContention()
+{
+    // Threads hammer the same few calls, so shards are often busy. Every
+    // find is accounted for and every cached value is the right one.
+    CallCache cache(64, 4);
+    constexpr int kThreads = 4;
+    constexpr int kRounds = 20000;
+    const QStringList calls = {"OG3Z", "OH2BH", "K1ABC", "JA1XYZ", "VK2AAA", "ZL1BBB"};
+    std::atomic<int> wrong{0};
+
+    QVector<QThread *> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.append(QThread::create([&cache, &calls, &wrong] {
+            for (int i = 0; i < kRounds; ++i) {
+                const int n = i % calls.size();
+                int value = -1;
+                if (cache.find(calls.at(n), &value)) {
+                    if (value != n) {
+                        ++wrong;
+                    }
+                } else {
+                    cache.insert(calls.at(n), n);
+                }
+            }
+        }));
+    }
+    for (QThread *thread : threads) {
+        thread->start();
+    }
+    for (QThread *thread : threads) {
+        QVERIFY(thread->wait(30000));
+        delete thread;
+    }
+
+    QCOMPARE(wrong.load(), 0);
+    const CallCache::Stats stats = cache.stats();
+    QVERIFY(stats.hits > 0);
+    QVERIFY(stats.hits + stats.misses <= quint64(kThreads * kRounds));
+    QVERIFY(stats.size <= calls.size());
+
+    // A resolver shared the same way gives the same answers, cached or not.
+    const QString data =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH,OI,OJ;\n"
+        "Japan:                    25:  45:  AS:   36.40:  -138.38:    -9.0:  JA:\n"
+        "    JA,JE,JF,JG,JH,JI,JJ,JK,JL,JM,JN,JO,JP,JQ,JR,JS;";
+    Country country;
+    country.ParseCty(data);
+    std::atomic<int> misresolved{0};
+    threads.clear();
+    for (int t = 0; t < kThreads; ++t) {
+        threads.append(QThread::create([&country, &misresolved] {
+            for (int i = 0; i < kRounds / 4; ++i) {
+                const bool finn = i % 2;
+                const CallInfo info = country.lookup(finn ? "OG3Z" : "JA1XYZ");
+                if (info.name != (finn ? "Finland" : "Japan")) {
+                    ++misresolved;
+                }
+            }
+        }));
+    }
+    for (QThread *thread : threads) {
+        thread->start();
+    }
+    for (QThread *thread : threads) {
+        QVERIFY(thread->wait(30000));
+        delete thread;
+    }
+    QCOMPARE(misresolved.load(), 0);
+}
+
+#include "callcache_test.moc"
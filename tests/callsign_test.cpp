@@ -0,0 +1,87 @@
+#include <QtTest/QtTest>
+
+#include "callsign.h"
+
+class CallsignTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void splitsParts_data();
+    void splitsParts();
+    void parsesBytes();
+    void rejectsInvalid();
+};
+
+QObject *createCallsignTest()
+{
+    return new CallsignTest();
+}
+
+void CallsignTest::splitsParts_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("call");
+    QTest::addColumn<QString>("base");
+    QTest::addColumn<QString>("prefix");
+    QTest::addColumn<int>("flags");
+    QTest::addColumn<QString>("areaBase");
+
+    QTest::newRow("plain") << "og3z" << "OG3Z" << "OG3Z" << "" << 0 << "";
+    QTest::newRow("prefix before") << "KH6/K1ABC" << "KH6/K1ABC" << "K1ABC" << "KH6" << 0 << "";
+    QTest::newRow("prefix after") << "OG3Z/OH0" << "OG3Z/OH0" << "OG3Z" << "OH0" << 0 << "";
+    QTest::newRow("letter prefix") << "F/OG3Z" << "F/OG3Z" << "OG3Z" << "F" << 0 << "";
+    QTest::newRow("portable") << " OH2BH/P " << "OH2BH/P" << "OH2BH" << "" << int(Callsign::Portable) << "";
+    QTest::newRow("prefix and flag") << "EA8/OH2BH/P" << "EA8/OH2BH/P" << "OH2BH" << "EA8"
+                                     << int(Callsign::Portable) << "";
+    QTest::newRow("mobile") << "DL1ABC/M" << "DL1ABC/M" << "DL1ABC" << "" << int(Callsign::Mobile) << "";
+    QTest::newRow("maritime") << "N2NL/MM" << "N2NL/MM" << "N2NL" << "" << int(Callsign::MaritimeMobile) << "";
+    QTest::newRow("aeronautical") << "K1ABC/AM" << "K1ABC/AM" << "K1ABC" << ""
+                                  << int(Callsign::AeronauticalMobile) << "";
+    QTest::newRow("qrp") << "OG3Z/P/QRP" << "OG3Z/P/QRP" << "OG3Z" << ""
+                         << int(Callsign::Portable | Callsign::Qrp) << "";
+    QTest::newRow("area") << "UA9ABC/1" << "UA9ABC/1" << "UA9ABC" << "" << 0 << "UA1ABC";
+    QTest::newRow("area digit first") << "3D2AB/5" << "3D2AB/5" << "3D2AB" << "" << 0 << "3D5AB";
+    QTest::newRow("unknown suffix") << "OH2WWA/LH" << "OH2WWA/LH" << "OH2WWA" << "" << 0 << "";
+    QTest::newRow("ssid") << "OH6BG-#" << "OH6BG" << "OH6BG" << "" << 0 << "";
+}
+
+void CallsignTest::splitsParts()
+{
+    QFETCH(QString, text);
+    QFETCH(QString, call);
+    QFETCH(QString, base);
+    QFETCH(QString, prefix);
+    QFETCH(int, flags);
+    QFETCH(QString, areaBase);
+
+    const Callsign parsed(text);
+    QVERIFY(parsed.isValid());
+    QCOMPARE(QString(parsed.call()), call);
+    QCOMPARE(QString(parsed.base()), base);
+    QCOMPARE(QString(parsed.prefix()), prefix);
+    QCOMPARE(int(parsed.flags()), flags);
+    QCOMPARE(QString(parsed.areaBase()), areaBase);
+}
+
+void CallsignTest::parsesBytes()
+{
+    const QByteArray line = "DX de OH6BG-#: 14025.0 kh6/k1abc/p CW";
+    const int start = line.indexOf("kh6");
+    const Callsign parsed(line.constData() + start, 11);
+    QCOMPARE(QString(parsed.base()), QString("K1ABC"));
+    QCOMPARE(QString(parsed.prefix()), QString("KH6"));
+    QVERIFY(parsed.has(Callsign::Portable));
+    QVERIFY(!parsed.isOffshore());
+}
+
+void CallsignTest::rejectsInvalid()
+{
+    QVERIFY(!Callsign(QString()).isValid());
+    QVERIFY(!Callsign(QString("/")).isValid());
+    QVERIFY(!Callsign(QString("K1 ABC")).isValid());
+    QVERIFY(!Callsign(QString("OG3Z.")).isValid());
+    QVERIFY(!Callsign(QString("A/B/C/D/E1")).isValid());
+    QVERIFY(!Callsign(QString(Callsign::kMaxLength + 1, QChar('A'))).isValid());
+}
+
+#include "callsign_test.moc"
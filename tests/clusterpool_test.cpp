@@ -0,0 +1,258 @@
+#include <QtTest/QtTest>
+#include <QScopeGuard>
+#include <QSettings>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+
+#include "clusterpool.h"
+#include "country.h"
+#include "neededmatrix.h"
+#include "spotdeduper.h"
+
+#include <algorithm>
+
+class ClusterPoolTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void readsNodes();
+    void defaultsWithoutNodes();
+    void scoresHealth();
+    void samplesLatencyBehindFirstNode();
+    void keepsQuietButDeliveringNodes();
+    void swapsSilentNodeForStandby();
+    void swapsDisconnectedNodeForStandby();
+};
+
+QObject *createClusterPoolTest()
+{
+    return new ClusterPoolTest();
+}
+
+void ClusterPoolTest::readsNodes()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QSettings settings(dir.filePath("nodes.ini"), QSettings::IniFormat);
+    settings.beginWriteArray("cluster/nodes");
+    settings.setArrayIndex(0);
+    settings.setValue("host", "ham.connect.fi");
+    settings.setValue("port", 7300);
+    settings.setValue("login", "og3z");
+    settings.setArrayIndex(1);
+    settings.setValue("host", "");
+    settings.setArrayIndex(2);
+    settings.setValue("host", "dxc.example.org");
+    settings.setValue("port", 8000);
+    settings.setValue("login", "oh2xx-1");
+    settings.endArray();
+
+    const QVector<ClusterNode> nodes = ClusterPool::nodesFromSettings(settings);
+    QCOMPARE(nodes.size(), 2);
+    QCOMPARE(nodes.at(0).host, QString("ham.connect.fi"));
+    QCOMPARE(nodes.at(0).port, quint16(7300));
+    QCOMPARE(nodes.at(1).host, QString("dxc.example.org"));
+    QCOMPARE(nodes.at(1).port, quint16(8000));
+    QCOMPARE(nodes.at(1).login, QString("oh2xx-1"));
+}
+
+void ClusterPoolTest::defaultsWithoutNodes()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QSettings settings(dir.filePath("empty.ini"), QSettings::IniFormat);
+    const QVector<ClusterNode> nodes = ClusterPool::nodesFromSettings(settings);
+    QCOMPARE(nodes.size(), 1);
+    QCOMPARE(nodes.first().host, QString("ham.connect.fi"));
+}
+
+void ClusterPoolTest::scoresHealth()
+{
+    ClusterNodeHealth fast;
+    fast.spotLines = 40;
+    ClusterNodeHealth slow = fast;
+    slow.latencyMs = 20000.0;
+    ClusterNodeHealth flaky = fast;
+    flaky.disconnects = 10;
+    ClusterNodeHealth untried;
+
+    QVERIFY(ClusterPool::score(fast) > ClusterPool::score(slow));
+    QVERIFY(ClusterPool::score(slow) > ClusterPool::score(flaky));
+    QVERIFY(ClusterPool::score(untried) > ClusterPool::score(flaky));
+}
+
+// Local cluster nodes: three listening servers, of which the pool connects
+// to two, and a resolver that knows Finland so OG3Z spots are needed.
+class LocalCluster
+{
+public:
+    LocalCluster()
+    {
+        auto country = std::make_shared<Country>();
+        country->ParseCty(QString("Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+                                  "    OF,OG,OH;\n"));
+        Country::publish(country);
+        matrix.mark(224, NeededMatrix::Band17);
+        for (QTcpServer &server : servers) {
+            server.listen(QHostAddress::LocalHost);
+            nodes.append({"127.0.0.1", server.serverPort(), "og3z"});
+        }
+    }
+
+    bool listening() const
+    {
+        return std::all_of(std::begin(servers), std::end(servers),
+                           [](const QTcpServer &server) { return server.isListening(); });
+    }
+
+    QTcpServer servers[3];
+    QVector<ClusterNode> nodes;
+    NeededMatrix matrix;
+    SpotDeduper deduper;
+};
+
+// Non-blocking, so QTRY_VERIFY keeps the pool's event loop turning.
+static QTcpSocket *nextClient(QTcpServer &server)
+{
+    return server.hasPendingConnections() ? server.nextPendingConnection() : nullptr;
+}
+
+// A DX line in the columns TcpReceiver reads.
+static QByteArray dxLine(const QString &call, const QString &freq)
+{
+    QString line = QString("DX de OH6BG:").leftJustified(24 - freq.size(), ' ') + freq;
+    line = line.leftJustified(25, ' ') + call;
+    line = line.leftJustified(39, ' ') + "CW 25 WPM CQ";
+    line = line.leftJustified(70, ' ') + "1234Z";
+    return line.toLatin1() + "\r\n";
+}
+
+static void sendTo(QTcpSocket *peer, const QByteArray &data)
+{
+    peer->write(data);
+    peer->flush();
+}
+
+void ClusterPoolTest::samplesLatencyBehindFirstNode()
+{
+    const auto restore = qScopeGuard([original = Country::shared()] { Country::publish(original); });
+    LocalCluster cluster;
+    QVERIFY(cluster.listening());
+    ClusterPool pool(cluster.nodes, &cluster.deduper);
+    pool.setNeededMatrix(&cluster.matrix);
+    QSignalSpy passed(&pool, &ClusterPool::spotReceived);
+    pool.start();
+
+    QTcpSocket *first = nullptr;
+    QTcpSocket *second = nullptr;
+    QTRY_VERIFY((first = nextClient(cluster.servers[0])) != nullptr);
+    QTRY_VERIFY((second = nextClient(cluster.servers[1])) != nullptr);
+    QTRY_VERIFY(pool.health(0).connected && pool.health(1).connected);
+
+    sendTo(first, dxLine("OG3Z", "14025.0"));
+    QTRY_COMPARE(passed.size(), 1);
+    QTest::qWait(100);
+    sendTo(second, dxLine("OG3Z", "14025.1"));
+    QTRY_VERIFY(pool.health(1).latencyMs > 0.0);
+
+    // The copy was dropped, and only the node that lagged is charged for it.
+    QCOMPARE(passed.size(), 1);
+    QCOMPARE(pool.health(0).latencyMs, 0.0);
+    QVERIFY(pool.health(1).latencyMs < 0.2 * ClusterPool::kMaxLatencySampleMs);
+    pool.stop();
+}
+
+void ClusterPoolTest::keepsQuietButDeliveringNodes()
+{
+    const auto restore = qScopeGuard([original = Country::shared()] { Country::publish(original); });
+    LocalCluster cluster;
+    QVERIFY(cluster.listening());
+    ClusterPool pool(cluster.nodes, &cluster.deduper);
+    pool.setNeededMatrix(&cluster.matrix);
+    QSignalSpy passed(&pool, &ClusterPool::spotReceived);
+    pool.start();
+
+    QTcpSocket *first = nullptr;
+    QTcpSocket *second = nullptr;
+    QTRY_VERIFY((first = nextClient(cluster.servers[0])) != nullptr);
+    QTRY_VERIFY((second = nextClient(cluster.servers[1])) != nullptr);
+    QTRY_VERIFY(pool.health(0).connected && pool.health(1).connected);
+
+    // Only the first node has a needed spot; the second still sends lines.
+    sendTo(first, dxLine("OG3Z", "14025.0"));
+    sendTo(second, dxLine("K1ABC", "14030.0"));
+    QTRY_COMPARE(pool.health(1).spotLines, 1);
+    QTRY_COMPARE(pool.health(0).spotLines, 1);
+    QCOMPARE(passed.size(), 1);
+
+    pool.evaluate(QDateTime::currentMSecsSinceEpoch() + ClusterPool::kEvaluateIntervalMs * 2);
+    QVERIFY(pool.health(0).active);
+    QVERIFY(pool.health(1).active);
+    QVERIFY(!pool.health(2).active);
+    QCOMPARE(pool.health(1).spotLines, 0);
+    pool.stop();
+}
+
+void ClusterPoolTest::swapsSilentNodeForStandby()
+{
+    const auto restore = qScopeGuard([original = Country::shared()] { Country::publish(original); });
+    LocalCluster cluster;
+    QVERIFY(cluster.listening());
+    ClusterPool pool(cluster.nodes, &cluster.deduper);
+    pool.setNeededMatrix(&cluster.matrix);
+    pool.start();
+
+    QTcpSocket *first = nullptr;
+    QTcpSocket *second = nullptr;
+    QTRY_VERIFY((first = nextClient(cluster.servers[0])) != nullptr);
+    QTRY_VERIFY((second = nextClient(cluster.servers[1])) != nullptr);
+    QTRY_VERIFY(pool.health(0).connected && pool.health(1).connected);
+    QVERIFY(!cluster.servers[2].hasPendingConnections());
+
+    // Connected but stuck: nothing for a whole period while the other delivers.
+    sendTo(first, dxLine("K1ABC", "14030.0"));
+    QTRY_COMPARE(pool.health(0).spotLines, 1);
+    pool.evaluate(QDateTime::currentMSecsSinceEpoch() + ClusterPool::kEvaluateIntervalMs * 2);
+
+    QVERIFY(pool.health(0).active);
+    QVERIFY(!pool.health(1).active);
+    QVERIFY(pool.health(2).active);
+    QTcpSocket *standby = nullptr;
+    QTRY_VERIFY((standby = nextClient(cluster.servers[2])) != nullptr);
+    QTRY_VERIFY(pool.health(2).connected);
+    pool.stop();
+}
+
+void ClusterPoolTest::swapsDisconnectedNodeForStandby()
+{
+    const auto restore = qScopeGuard([original = Country::shared()] { Country::publish(original); });
+    LocalCluster cluster;
+    QVERIFY(cluster.listening());
+    ClusterPool pool(cluster.nodes, &cluster.deduper);
+    pool.start();
+
+    QTcpSocket *first = nullptr;
+    QTRY_VERIFY((first = nextClient(cluster.servers[0])) != nullptr);
+    QTRY_VERIFY(nextClient(cluster.servers[1]) != nullptr);
+    QTRY_VERIFY(pool.health(0).connected && pool.health(1).connected);
+
+    // The first node goes away for good.
+    cluster.servers[0].close();
+    first->close();
+    QTRY_VERIFY(!pool.health(0).connected);
+    QCOMPARE(pool.health(0).disconnects, 1);
+
+    // Within the grace period a reconnect may still succeed.
+    pool.evaluate(QDateTime::currentMSecsSinceEpoch());
+    QVERIFY(pool.health(0).active);
+
+    pool.evaluate(QDateTime::currentMSecsSinceEpoch() + ClusterPool::kReconnectGraceMs + 1000);
+    QVERIFY(!pool.health(0).active);
+    QVERIFY(pool.health(1).active);
+    QVERIFY(pool.health(2).active);
+    QTRY_VERIFY(pool.health(2).connected);
+    pool.stop();
+}
+
+#include "clusterpool_test.moc"
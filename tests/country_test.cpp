@@ -1,14 +1,179 @@
 #include <QtTest/QtTest>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QScopeGuard>
+#include <QTemporaryDir>
 
 #include "country.h"
+#include "dxccentity.h"
 
 class CountryTest : public QObject
 {
     Q_OBJECT
 private slots:
     void parseAndLookup();
+    void keepsZoneOverrides();
+    void trieMatchesLinearScan();
+    void resolvesParsedCalls_data();
+    void resolvesParsedCalls();
+    void snapshotRoundTrip();
+    void snapshotPerSource();
+    void reloadCountsChangedEntities();
+    void layersResolveByPrecedence();
+    void batchMatchesSingleLookups();
+    void benchmarkLegacyParse();
+    void benchmarkParse();
+    void benchmarkBatchLookup();
 };
 
+// cty.dat handling as it was before the compiled index: a regex-based
+// parser into hash maps and a linear scan over prefixMap. Serves as the
+// reference for equivalence tests and as the benchmark baseline.
+struct LegacyCty
+{
+    QHash<QString, QString> callMap;
+    QHash<QString, QString> prefixMap;
+    QHash<QString, QString> countryContinent;
+    QHash<QString, QString> headerPrefixes;
+
+    void parse(const QString &content);
+    QString getCountry(const QString &call, QString *continent = nullptr) const;
+    // Name Country reports for a cty.dat entity name returned by getCountry.
+    QString dxccName(const QString &country) const;
+};
+
+void LegacyCty::parse(const QString &content)
+{
+    const QStringList blocks = content.split(';', Qt::SkipEmptyParts);
+    for (const QString &block : blocks) {
+        const QString trimmedBlock = block.trimmed();
+        if (trimmedBlock.isEmpty()) {
+            continue;
+        }
+
+        const QStringList lines = trimmedBlock.split(QRegularExpression(R"(\r?\n)"), Qt::SkipEmptyParts);
+        if (lines.isEmpty()) {
+            continue;
+        }
+
+        const QString header = lines.first().trimmed();
+        const QStringList headerParts = header.split(':', Qt::SkipEmptyParts);
+        if (headerParts.size() < 8) {
+            continue;
+        }
+
+        const QString country = headerParts.at(0).trimmed();
+        const QString continent = headerParts.at(3).trimmed();
+        const QString headerPrefix = headerParts.at(7).trimmed();
+        if (headerPrefix.startsWith('*')) {
+            continue;
+        }
+        if (!country.isEmpty() && !continent.isEmpty()) {
+            countryContinent.insert(country.toUpper(), continent.toUpper());
+        }
+        headerPrefixes.insert(country, headerPrefix);
+        QStringList prefixes;
+        if (!headerPrefix.isEmpty()) {
+            prefixes << headerPrefix;
+        }
+
+        QStringList calls;
+
+        QString rest;
+        for (int i = 1; i < lines.size(); ++i) {
+            if (!rest.isEmpty()) {
+                rest.append(',');
+            }
+            rest.append(lines.at(i));
+        }
+
+        const QStringList tokens = rest.split(',', Qt::SkipEmptyParts);
+        for (QString token : tokens) {
+            token = token.trimmed();
+            if (token.isEmpty()) {
+                continue;
+            }
+            const bool isCall = token.startsWith('=');
+            if (isCall) {
+                token.remove(0, 1);
+            }
+            token.replace(QRegularExpression(R"(\(.*?\))"), "");
+            token.replace(QRegularExpression(R"(\[.*?\])"), "");
+            token = token.trimmed();
+            if (token.isEmpty()) {
+                continue;
+            }
+            if (isCall) {
+                calls << token;
+            } else {
+                prefixes << token;
+            }
+        }
+
+        for (const QString &call : calls) {
+            callMap.insert(call.toUpper(), country);
+        }
+        for (const QString &prefix : prefixes) {
+            prefixMap.insert(prefix.toUpper(), country);
+        }
+    }
+}
+
+QString LegacyCty::getCountry(const QString &call, QString *continent) const
+{
+    const QString key = call.toUpper();
+
+    auto resolve = [&](const QString &k) -> QString {
+        const QString direct = callMap.value(k, QString());
+        if (!direct.isEmpty()) {
+            return direct;
+        }
+        QString best;
+        for (auto it = prefixMap.constBegin(); it != prefixMap.constEnd(); ++it) {
+            const QString &prefix = it.key();
+            if (k.startsWith(prefix) && prefix.size() > best.size()) {
+                best = prefix;
+            }
+        }
+        return best.isEmpty() ? QString() : prefixMap.value(best);
+    };
+
+    QStringList candidates;
+    candidates << key << key.split('/', Qt::SkipEmptyParts);
+    for (const QString &candidate : candidates) {
+        const QString result = resolve(candidate);
+        if (result.isEmpty()) {
+            continue;
+        }
+        if (continent) {
+            const QString cont = countryContinent.value(result.toUpper());
+            if (!cont.isEmpty()) {
+                *continent = cont;
+            }
+        }
+        return result;
+    }
+    return QString();
+}
+
+QString LegacyCty::dxccName(const QString &country) const
+{
+    if (country.isEmpty()) {
+        return QString();
+    }
+    const DxccEntity *entity = dxccEntityForCtyPrefix(headerPrefixes.value(country).toLatin1());
+    return entity ? QString::fromLatin1(entity->name) : country;
+}
+
+static QByteArray shippedCty()
+{
+    QFile file(QFINDTESTDATA("../cty.dat"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
 QObject *createCountryTest()
 {
     return new CountryTest();
@@ -48,9 +213,360 @@ void CountryTest::parseAndLookup()
         "Bouvet:                   38:  67:  AF:  -54.42:    -3.38:    -1.0:  3Y/b:\n"
         "    =3Y0K,=3Y/ZS6GCM,=3Y0C,=3Y0E,=3Y0J,=3Y7GIA,=3Y7THA;";
     country.ParseCty(data);
-    QCOMPARE(country.GetCountry("3Y0K"), QString("Bouvet"));
-    qDebug() << country.callMap;
-    qDebug() << country.prefixMap;
+    QCOMPARE(country.GetCountry("3Y0K"), QString("BOUVET ISLAND"));
+    QCOMPARE(country.lookup("3Y0K").dxcc, 24);
+    QCOMPARE(country.lookup("3Y0C").dxcc, 24);
+}
+
+void CountryTest::keepsZoneOverrides()
+{
+    Country country;
+    country.ParseCty(QString(
+        "United States:            05:  08:  NA:   37.60:    91.87:     5.0:  K:\n"
+        "    AA,K,KH6(31)[61],=N2NL/MM(7),=W1AW<41.71/72.73>{EU}~-4.0~;"));
+
+    const CallInfo plain = country.lookup("K1ABC");
+    QVERIFY(plain.isValid());
+    QCOMPARE(plain.name, QString("UNITED STATES OF AMERICA"));
+    QCOMPARE(plain.dxcc, 291);
+    QCOMPARE(plain.continent, QString("NA"));
+    QCOMPARE(plain.cqZone, 5);
+    QCOMPARE(plain.ituZone, 8);
+    QCOMPARE(plain.latitude, double(float(37.60)));
+    QCOMPARE(plain.longitude, double(float(91.87)));
+    QCOMPARE(plain.utcOffset, 5.0);
+
+    const CallInfo prefix = country.lookup("KH6ABC");
+    QCOMPARE(prefix.entity, plain.entity);
+    QCOMPARE(prefix.cqZone, 31);
+    QCOMPARE(prefix.ituZone, 61);
+
+    const CallInfo exact = country.lookup("N2NL/MM");
+    QCOMPARE(exact.cqZone, 7);
+    QCOMPARE(exact.ituZone, 8);
+
+    const CallInfo located = country.lookup("w1aw");
+    QCOMPARE(located.latitude, double(float(41.71)));
+    QCOMPARE(located.longitude, double(float(72.73)));
+    QCOMPARE(located.continent, QString("EU"));
+    QCOMPARE(located.utcOffset, -4.0);
+
+    QVERIFY(!country.lookup("OG3Z").isValid());
+}
+
+void CountryTest::trieMatchesLinearScan()
+{
+    const QByteArray content = shippedCty();
+    QVERIFY(!content.isEmpty());
+    Country country;
+    country.ParseCty(content);
+    LegacyCty legacy;
+    legacy.parse(QString::fromUtf8(content));
+    QCOMPARE(country.exactCallCount(), legacy.callMap.size());
+
+    QStringList calls = {
+        "OG3Z", "OH2BH", "K1ABC", "KH6/K1ABC", "VP2EAA", "3Y0K", "3D2CR", "OH0/OG3Z",
+        "OG3Z/MM", "EA8/OH2BH/P", "F/OG3Z", "1A0KM", "ZZ9ZZZ", "", "/", "Q1AA", "TA1/DL1ABC"
+    };
+    const QStringList prefixes = legacy.prefixMap.keys();
+    for (const QString &prefix : prefixes) {
+        calls << prefix + "1AB";
+    }
+    const QStringList exactCalls = legacy.callMap.keys();
+    for (int i = 0; i < exactCalls.size(); i += 25) {
+        calls << exactCalls.at(i) << exactCalls.at(i) + "/P" << "OG3Z/" + exactCalls.at(i);
+    }
+
+    for (const QString &call : calls) {
+        // Slashed calls resolve from their parsed parts; see resolvesParsedCalls.
+        if (call.contains('/')) {
+            continue;
+        }
+        QString continent;
+        QString legacyContinent;
+        const QString result = country.GetCountry(call, &continent);
+        const QString expected = legacy.dxccName(legacy.getCountry(call, &legacyContinent));
+        if (result != expected || continent != legacyContinent) {
+            qDebug() << "Mismatch for" << call << result << continent << expected << legacyContinent;
+        }
+        QCOMPARE(result, expected);
+        QCOMPARE(continent, legacyContinent);
+    }
+}
+
+void CountryTest::resolvesParsedCalls_data()
+{
+    QTest::addColumn<QString>("call");
+    QTest::addColumn<int>("dxcc");
+
+    QTest::newRow("plain") << "OG3Z" << 224;
+    QTest::newRow("portable") << "OG3Z/P" << 224;
+    QTest::newRow("prefix before") << "KH6/K1ABC" << 110;
+    QTest::newRow("prefix after") << "OG3Z/OH0" << 5;
+    QTest::newRow("letter prefix") << "F/OG3Z" << 227;
+    QTest::newRow("prefix and flag") << "EA8/OH2BH/P" << 29;
+    QTest::newRow("exact with suffix") << "3Y0K/P" << 24;
+    QTest::newRow("area change") << "UA9ABC/1" << 54;
+    QTest::newRow("same area entity") << "K1ABC/4" << 291;
+    QTest::newRow("maritime mobile") << "OG3Z/MM" << 0;
+    QTest::newRow("aeronautical mobile") << "K1ABC/AM" << 0;
+    QTest::newRow("cluster ssid") << "OH6BG-#" << 224;
+    QTest::newRow("invalid") << "OG3Z." << 0;
+}
+
+void CountryTest::resolvesParsedCalls()
+{
+    QFETCH(QString, call);
+    QFETCH(int, dxcc);
+
+    const QByteArray content = shippedCty();
+    QVERIFY(!content.isEmpty());
+    Country country;
+    country.ParseCty(content);
+    QCOMPARE(country.lookup(call).dxcc, dxcc);
+}
+
+void CountryTest::snapshotRoundTrip()
+{
+    const QByteArray content = shippedCty();
+    QVERIFY(!content.isEmpty());
+    const QByteArray hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+    Country parsed;
+    parsed.ParseCty(content);
+    LegacyCty legacy;
+    legacy.parse(QString::fromUtf8(content));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("cty.bin");
+    QVERIFY(parsed.saveSnapshot(path, hash));
+
+    Country stale;
+    QVERIFY(!stale.loadSnapshot(path, QCryptographicHash::hash("other", QCryptographicHash::Sha1)));
+
+    Country loaded;
+    QVERIFY(loaded.loadSnapshot(path, hash));
+    QCOMPARE(loaded.entityCount(), parsed.entityCount());
+    QCOMPARE(loaded.exactCallCount(), parsed.exactCallCount());
+
+    QStringList calls = { "OG3Z", "K1ABC", "KH6/K1ABC", "3Y0K", "3D2CR", "OH0/OG3Z", "ZZ9ZZZ", "VP8/G3ABC" };
+    const QStringList exactCalls = legacy.callMap.keys();
+    for (int i = 0; i < exactCalls.size(); i += 50) {
+        calls << exactCalls.at(i);
+    }
+    const QStringList prefixes = legacy.prefixMap.keys();
+    for (int i = 0; i < prefixes.size(); i += 10) {
+        calls << prefixes.at(i) + "2XY";
+    }
+    for (const QString &call : calls) {
+        const CallInfo expected = parsed.lookup(call);
+        const CallInfo actual = loaded.lookup(call);
+        QCOMPARE(actual.entity, expected.entity);
+        QCOMPARE(actual.name, expected.name);
+        QCOMPARE(actual.dxcc, expected.dxcc);
+        QCOMPARE(actual.continent, expected.continent);
+        QCOMPARE(actual.cqZone, expected.cqZone);
+        QCOMPARE(actual.ituZone, expected.ituZone);
+    }
+}
+
+void CountryTest::snapshotPerSource()
+{
+    const QString cty =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH;\n";
+    const QByteArray oldHash = QCryptographicHash::hash("old", QCryptographicHash::Sha1);
+    const QByteArray newHash = QCryptographicHash::hash("new", QCryptographicHash::Sha1);
+    QVERIFY(Country::snapshotPath(oldHash) != Country::snapshotPath(newHash));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString oldPath = dir.filePath(QFileInfo(Country::snapshotPath(oldHash)).fileName());
+    const QString newPath = dir.filePath(QFileInfo(Country::snapshotPath(newHash)).fileName());
+    Country parsed;
+    parsed.ParseCty(cty);
+    QVERIFY(parsed.saveSnapshot(oldPath, oldHash));
+
+    // A reload writes beside the snapshot the running resolver maps.
+    Country running;
+    QVERIFY(running.loadSnapshot(oldPath, oldHash));
+    QVERIFY(parsed.saveSnapshot(newPath, newHash));
+    Country::removeStaleSnapshots(newPath);
+    QCOMPARE(running.lookup("OG3Z").dxcc, 224);
+
+    Country reloaded;
+    QVERIFY(reloaded.loadSnapshot(newPath, newHash));
+    QCOMPARE(reloaded.lookup("OG3Z").dxcc, 224);
+}
+
+void CountryTest::reloadCountsChangedEntities()
+{
+    const QString before =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH,=OH0XX;\n"
+        "Sweden:                   14:  18:  EU:   61.20:   -14.57:    -1.0:  SM:\n"
+        "    SA,SM;\n"
+        "Norway:                   14:  18:  EU:   61.00:    -9.00:    -1.0:  LA:\n"
+        "    LA;\n";
+    const QString after =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH,OI,=OH0XX;\n"
+        "Sweden:                   14:  18:  EU:   61.20:   -14.57:    -1.0:  SM:\n"
+        "    SA,SM;\n"
+        "Norway:                   14:  18:  EU:   61.00:    -9.00:    -1.0:  LA:\n"
+        "    LA(40);\n"
+        "Estonia:                  15:  29:  EU:   58.60:   -25.00:    -2.0:  ES:\n"
+        "    ES;\n";
+
+    auto current = std::make_shared<Country>();
+    current->ParseCty(before);
+    auto reloaded = std::make_shared<Country>();
+    reloaded->ParseCty(after);
+
+    QCOMPARE(Country::changedEntities(*current, *current), 0);
+    QCOMPARE(Country::changedEntities(*current, *reloaded), 3);
+    QCOMPARE(Country::changedEntities(*reloaded, *current), 3);
+
+    // Later suites resolve through shared(); give them the real one back.
+    const std::shared_ptr<const Country> original = Country::shared();
+    const auto restore = qScopeGuard([&original] { Country::publish(original); });
+    Country::publish(current);
+    const std::shared_ptr<const Country> held = Country::shared();
+    QCOMPARE(held.get(), current.get());
+    Country::publish(reloaded);
+    QCOMPARE(Country::shared().get(), reloaded.get());
+    // A resolver fetched before the swap keeps answering from the old tables.
+    QVERIFY(!held->lookup("OI1AB").isValid());
+    QVERIFY(Country::shared()->lookup("OI1AB").isValid());
+}
+
+void CountryTest::layersResolveByPrecedence()
+{
+    const QByteArray cty =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH;\n"
+        "Aland Islands:            15:  18:  EU:   60.13:   -20.37:    -2.0:  OH0:\n"
+        "    OH0;\n"
+        "Sweden:                   14:  18:  EU:   61.20:   -14.57:    -1.0:  SM:\n"
+        "    SA,SM;\n";
+    const QByteArray override =
+        "Sweden:                   14:  18:  EU:   61.20:   -14.57:    -1.0:  SM:\n"
+        "    OH9,=OH0XX;\n";
+    const QByteArray big =
+        "Finland:                  15:  18:  EU:   63.78:   -27.08:    -2.0:  OH:\n"
+        "    OF,OG,OH,OH9,=OH0XX,=OH2BIG;\n";
+
+    Country country;
+    country.addCty(cty, Country::CtyLayer);
+    // Added after the override, but a lower layer never wins.
+    country.addCty(override, Country::OverrideLayer);
+    country.addCty(big, Country::BigCtyLayer);
+    QTest::ignoreMessage(QtWarningMsg, "Call list entry not indexed: \"OH7X,Atlantis\"");
+    country.addCalls("call,country\nOH2BIG,Sweden\nOH8WWA,284\nOH7X,Atlantis\n", Country::SpecialEventLayer);
+    country.addCalls("# exceptions\nOH2BIG,Aland Islands\n", Country::ExceptionLayer);
+    country.compile();
+
+    Country::Resolution r = country.explain("OH1AB");
+    QCOMPARE(r.info.dxcc, 224);
+    QCOMPARE(r.layer, Country::CtyLayer);
+    QVERIFY(!r.exactCall);
+    QCOMPARE(r.match, QString("OH"));
+
+    r = country.explain("oh9abc");
+    QCOMPARE(r.info.dxcc, 284);
+    QCOMPARE(r.layer, Country::OverrideLayer);
+    QCOMPARE(r.match, QString("OH9"));
+
+    r = country.explain("OH0XX/P");
+    QCOMPARE(r.info.dxcc, 284);
+    QCOMPARE(r.layer, Country::OverrideLayer);
+    QVERIFY(r.exactCall);
+    QCOMPARE(r.match, QString("OH0XX"));
+
+    r = country.explain("OH8WWA");
+    QCOMPARE(r.info.dxcc, 284);
+    QCOMPARE(r.layer, Country::SpecialEventLayer);
+
+    r = country.explain("OH2BIG");
+    QCOMPARE(r.info.dxcc, 5);
+    QCOMPARE(r.layer, Country::ExceptionLayer);
+    QCOMPARE(country.lookup("OH2BIG").dxcc, 5);
+
+    r = country.explain("XX1A");
+    QVERIFY(!r.info.isValid());
+    QVERIFY(r.match.isEmpty());
+}
+
+// A log-sized call list with repeats, built from the shipped prefixes.
+static QVector<QString> logCalls(const LegacyCty &legacy, int count)
+{
+    const QStringList prefixes = legacy.prefixMap.keys();
+    QVector<QString> calls;
+    calls.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString &prefix = prefixes.at(i % prefixes.size());
+        calls.append(prefix.toLower() + QString::number(i % 7) + "A" + QChar('A' + i % 26));
+    }
+    return calls;
+}
+
+void CountryTest::batchMatchesSingleLookups()
+{
+    const QByteArray content = shippedCty();
+    QVERIFY(!content.isEmpty());
+    Country country;
+    country.ParseCty(content);
+    LegacyCty legacy;
+    legacy.parse(QString::fromUtf8(content));
+
+    // Large enough to be split across the pool.
+    QVector<QString> calls = logCalls(legacy, 60000);
+    calls << "OG3Z" << "" << "ZZ9ZZZ" << "KH6/K1ABC" << "og3z";
+    const QVector<CallInfo> batch = country.lookupBatch(calls);
+    QCOMPARE(batch.size(), calls.size());
+    for (int i = 0; i < calls.size(); ++i) {
+        const CallInfo single = country.lookup(calls.at(i));
+        QCOMPARE(batch.at(i).entity, single.entity);
+        QCOMPARE(batch.at(i).dxcc, single.dxcc);
+        QCOMPARE(batch.at(i).cqZone, single.cqZone);
+    }
+    QCOMPARE(batch.last().dxcc, batch.at(calls.size() - 5).dxcc);
+    QVERIFY(country.lookupBatch(QVector<QString>()).isEmpty());
+}
+
+void CountryTest::benchmarkLegacyParse()
+{
+    const QString content = QString::fromUtf8(shippedCty());
+    QVERIFY(!content.isEmpty());
+    QBENCHMARK {
+        LegacyCty legacy;
+        legacy.parse(content);
+    }
+}
+
+void CountryTest::benchmarkParse()
+{
+    const QByteArray content = shippedCty();
+    QVERIFY(!content.isEmpty());
+    QBENCHMARK {
+        Country country;
+        country.ParseCty(content);
+    }
+}
+
+void CountryTest::benchmarkBatchLookup()
+{
+    const QByteArray content = shippedCty();
+    QVERIFY(!content.isEmpty());
+    Country country;
+    country.ParseCty(content);
+    LegacyCty legacy;
+    legacy.parse(QString::fromUtf8(content));
+    const QVector<QString> calls = logCalls(legacy, 200000);
+    QBENCHMARK {
+        country.lookupBatch(calls);
+    }
 }
 
 #include "country_test.moc"
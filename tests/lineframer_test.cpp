@@ -0,0 +1,99 @@
+#include <QtTest/QtTest>
+#include <QBuffer>
+
+#include "lineframer.h"
+
+class LineFramerTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void framesBurst();
+    void carriesPartialLine();
+    void acceptsLineEndings();
+    void dropsOverlongLine();
+    void readsFromDevice();
+};
+
+QObject *createLineFramerTest()
+{
+    return new LineFramerTest();
+}
+
+static QList<QByteArray> drain(LineFramer &framer)
+{
+    QList<QByteArray> lines;
+    QByteArrayView line;
+    while (framer.next(&line)) {
+        lines.append(line.toByteArray());
+    }
+    return lines;
+}
+
+void LineFramerTest::framesBurst()
+{
+    const QByteArray spot = "DX de PC4Y:      14024.8  SP2QG        CW                             1324Z\r\n";
+    QByteArray burst;
+    for (int i = 0; i < 500; ++i) {
+        burst += spot;
+    }
+
+    LineFramer framer;
+    framer.append(burst);
+    const QList<QByteArray> lines = drain(framer);
+    QCOMPARE(lines.size(), 500);
+    QCOMPARE(lines.first(), spot.chopped(2));
+    QCOMPARE(lines.last(), spot.chopped(2));
+    QCOMPARE(framer.pending(), 0);
+}
+
+void LineFramerTest::carriesPartialLine()
+{
+    LineFramer framer;
+    framer.append(QByteArrayView("DX de OH2A:  7020.0  OG3Z  CW  1200Z\r\nDX de OH2B:  140"));
+    QCOMPARE(drain(framer), QList<QByteArray>{"DX de OH2A:  7020.0  OG3Z  CW  1200Z"});
+    QVERIFY(framer.pending() > 0);
+
+    framer.append(QByteArrayView("74.0  K1ABC  FT8"));
+    QVERIFY(drain(framer).isEmpty());
+
+    framer.append(QByteArrayView("  1201Z\r"));
+    QVERIFY(drain(framer).isEmpty());
+    framer.append(QByteArrayView("\n"));
+    QCOMPARE(drain(framer), QList<QByteArray>{"DX de OH2B:  14074.0  K1ABC  FT8  1201Z"});
+    QCOMPARE(framer.pending(), 0);
+}
+
+void LineFramerTest::acceptsLineEndings()
+{
+    LineFramer framer;
+    framer.append(QByteArrayView("crlf\r\nlf\nlfcr\n\rlast\n\n"));
+    const QList<QByteArray> expected = {"crlf", "lf", "lfcr", "last", ""};
+    QCOMPARE(drain(framer), expected);
+}
+
+void LineFramerTest::dropsOverlongLine()
+{
+    LineFramer framer;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^Dropping \\d+ bytes without a line break$"));
+    framer.append(QByteArray(LineFramer::kMaxLineLength + 1, 'x'));
+    QCOMPARE(framer.pending(), 0);
+
+    framer.append(QByteArrayView("ok\r\n"));
+    QCOMPARE(drain(framer), QList<QByteArray>{"ok"});
+}
+
+void LineFramerTest::readsFromDevice()
+{
+    QByteArray data = "first\r\nsecond\r\nthi";
+    QBuffer device(&data);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    LineFramer framer;
+    QCOMPARE(framer.readFrom(&device), qint64(data.size()));
+    const QList<QByteArray> expected = {"first", "second"};
+    QCOMPARE(drain(framer), expected);
+    QCOMPARE(framer.pending(), 3);
+    QCOMPARE(framer.readFrom(&device), qint64(0));
+}
+
+#include "lineframer_test.moc"
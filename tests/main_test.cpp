@@ -4,6 +4,19 @@ QObject *createFrequencyLabelTest();
 QObject *createRigTest();
 QObject *createCountryTest();
 QObject *createTcpReceiverTest();
+QObject *createCallCacheTest();
+QObject *createCallsignTest();
+QObject *createLineFramerTest();
+QObject *createNeededMatrixTest();
+QObject *createBandPlanTest();
+QObject *createSpotModeTest();
+QObject *createRbnReceiverTest();
+QObject *createRbnAggregatorTest();
+QObject *createSpotDeduperTest();
+QObject *createClusterPoolTest();
+QObject *createTelnetSessionTest();
+QObject *createSpotTableModelTest();
+QObject *createSpotWriterTest();
 
 int main(int argc, char **argv)
 {
@@ -26,5 +39,57 @@ int main(int argc, char **argv)
     status |= QTest::qExec(tcpReceiverTest, argc, argv);
     delete tcpReceiverTest;
 
+    QObject *callCacheTest = createCallCacheTest();
+    status |= QTest::qExec(callCacheTest, argc, argv);
+    delete callCacheTest;
+
+    QObject *callsignTest = createCallsignTest();
+    status |= QTest::qExec(callsignTest, argc, argv);
+    delete callsignTest;
+
+    QObject *lineFramerTest = createLineFramerTest();
+    status |= QTest::qExec(lineFramerTest, argc, argv);
+    delete lineFramerTest;
+
+    QObject *neededMatrixTest = createNeededMatrixTest();
+    status |= QTest::qExec(neededMatrixTest, argc, argv);
+    delete neededMatrixTest;
+
+    QObject *bandPlanTest = createBandPlanTest();
+    status |= QTest::qExec(bandPlanTest, argc, argv);
+    delete bandPlanTest;
+
+    QObject *spotModeTest = createSpotModeTest();
+    status |= QTest::qExec(spotModeTest, argc, argv);
+    delete spotModeTest;
+
+    QObject *rbnReceiverTest = createRbnReceiverTest();
+    status |= QTest::qExec(rbnReceiverTest, argc, argv);
+    delete rbnReceiverTest;
+
+    QObject *rbnAggregatorTest = createRbnAggregatorTest();
+    status |= QTest::qExec(rbnAggregatorTest, argc, argv);
+    delete rbnAggregatorTest;
+
+    QObject *spotDeduperTest = createSpotDeduperTest();
+    status |= QTest::qExec(spotDeduperTest, argc, argv);
+    delete spotDeduperTest;
+
+    QObject *clusterPoolTest = createClusterPoolTest();
+    status |= QTest::qExec(clusterPoolTest, argc, argv);
+    delete clusterPoolTest;
+
+    QObject *telnetSessionTest = createTelnetSessionTest();
+    status |= QTest::qExec(telnetSessionTest, argc, argv);
+    delete telnetSessionTest;
+
+    QObject *spotTableModelTest = createSpotTableModelTest();
+    status |= QTest::qExec(spotTableModelTest, argc, argv);
+    delete spotTableModelTest;
+
+    QObject *spotWriterTest = createSpotWriterTest();
+    status |= QTest::qExec(spotWriterTest, argc, argv);
+    delete spotWriterTest;
+
     return status;
 }
@@ -0,0 +1,73 @@
+#include <QtTest/QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "neededmatrix.h"
+
+class NeededMatrixTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void loadsTable();
+    void marksWrites();
+};
+
+QObject *createNeededMatrixTest()
+{
+    return new NeededMatrixTest();
+}
+
+void NeededMatrixTest::loadsTable()
+{
+    const QString connection = "neededmatrix_test";
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+        db.setDatabaseName(":memory:");
+        QVERIFY(db.open());
+        QSqlQuery q(db);
+        QVERIFY(q.exec(R"(CREATE TABLE dxcc (Mix TEXT, Ph TEXT, CW TEXT, RT TEXT, SAT TEXT,
+                          "160" TEXT, "80" TEXT, "40" TEXT, "30" TEXT, "20" TEXT, "17" TEXT,
+                          "15" TEXT, "12" TEXT, "10" TEXT, "6" TEXT, "2" TEXT, dxcc INTEGER))"));
+        QVERIFY(q.exec(R"(INSERT INTO dxcc (dxcc, Mix, CW, "20") VALUES (224, 'X', 'X', 'V'))"));
+        QVERIFY(q.exec(R"(INSERT INTO dxcc (dxcc, "40") VALUES (284, ' '))"));
+
+        NeededMatrix matrix;
+        QVERIFY(matrix.load(db));
+        QVERIFY(matrix.contains(224));
+        QVERIFY(matrix.isMarked(224, NeededMatrix::Mix));
+        QVERIFY(matrix.isMarked(224, NeededMatrix::Cw));
+        QVERIFY(matrix.isMarked(224, NeededMatrix::Band20));
+        QVERIFY(!matrix.isMarked(224, NeededMatrix::Band40));
+        QVERIFY(!matrix.isMarked(224, NeededMatrix::Phone));
+
+        QVERIFY(matrix.contains(284));
+        QVERIFY(!matrix.isMarked(284, NeededMatrix::Band40));
+        QVERIFY(!matrix.contains(291));
+        QVERIFY(!matrix.isMarked(291, NeededMatrix::Band20));
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+void NeededMatrixTest::marksWrites()
+{
+    QCOMPARE(NeededMatrix::columnForName("160"), NeededMatrix::Band160);
+    QCOMPARE(NeededMatrix::columnForName("ph"), NeededMatrix::Phone);
+    QCOMPARE(NeededMatrix::columnForName("RT"), NeededMatrix::Data);
+    QCOMPARE(NeededMatrix::columnForName("60"), NeededMatrix::NoColumn);
+
+    NeededMatrix matrix;
+    QVERIFY(!matrix.contains(5));
+    matrix.mark(5, NeededMatrix::Band17);
+    QVERIFY(matrix.contains(5));
+    QVERIFY(matrix.isMarked(5, NeededMatrix::Band17));
+    QVERIFY(!matrix.isMarked(5, NeededMatrix::Band15));
+
+    // Out-of-range codes and columns are ignored.
+    matrix.mark(0, NeededMatrix::Mix);
+    matrix.mark(NeededMatrix::kMaxDxcc, NeededMatrix::Mix);
+    matrix.mark(5, NeededMatrix::NoColumn);
+    QVERIFY(!matrix.contains(0));
+    QVERIFY(!matrix.isMarked(5, NeededMatrix::NoColumn));
+}
+
+#include "neededmatrix_test.moc"
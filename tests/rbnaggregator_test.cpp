@@ -0,0 +1,135 @@
+#include <QtTest/QtTest>
+
+#include "rbnaggregator.h"
+
+class RbnAggregatorTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void mergesSkimmers();
+    void separatesFrequencies();
+    void mergesAcrossKhzBoundary();
+    void updatesOncePerWindow();
+    void waitsForLoneSkimmer();
+    void expiresReports();
+};
+
+QObject *createRbnAggregatorTest()
+{
+    return new RbnAggregatorTest();
+}
+
+static RbnSpot rbnSpot(const QString &spotter, qint64 hz, int snr, int speed = 25)
+{
+    RbnSpot spot;
+    spot.spotter = spotter;
+    spot.call = "OG3Z";
+    spot.mode = "CW";
+    spot.hz = hz;
+    spot.snr = snr;
+    spot.speed = speed;
+    return spot;
+}
+
+void RbnAggregatorTest::mergesSkimmers()
+{
+    RbnAggregator aggregator;
+    aggregator.add(rbnSpot("OH6BG", 14025000, 12, 24), "EU", 1000);
+    aggregator.add(rbnSpot("DK9IP", 14025100, 5, 25), "EU", 1200);
+    aggregator.add(rbnSpot("W3LPL", 14024900, 20, 26), "NA", 1500);
+    // A repeat from the same skimmer replaces its earlier report.
+    aggregator.add(rbnSpot("OH6BG", 14025000, 15, 25), "EU", 1800);
+
+    const QVector<RbnAggregate> updates = aggregator.takeUpdates(6000);
+    QCOMPARE(updates.size(), 1);
+    const RbnAggregate &spot = updates.first();
+    QCOMPARE(spot.call, QString("OG3Z"));
+    QCOMPARE(spot.skimmers, 3);
+    QCOMPARE(spot.minSnr, 5);
+    QCOMPARE(spot.maxSnr, 20);
+    QCOMPARE(spot.medianSnr, 15);
+    QCOMPARE(spot.speed, 25);
+    QCOMPARE(spot.hz, qint64(14025000));
+    QCOMPARE(spot.firstSeenMs, qint64(1000));
+    QCOMPARE(spot.lastSeenMs, qint64(1800));
+    QCOMPARE(spot.continents, QStringList({"EU", "NA"}));
+}
+
+void RbnAggregatorTest::separatesFrequencies()
+{
+    RbnAggregator aggregator;
+    aggregator.add(rbnSpot("OH6BG", 14025000, 12), "EU", 1000);
+    aggregator.add(rbnSpot("OH6BG", 7025000, 12), "EU", 1000);
+    QCOMPARE(aggregator.size(), 2);
+    QCOMPARE(aggregator.takeUpdates(31000).size(), 2);
+}
+
+void RbnAggregatorTest::mergesAcrossKhzBoundary()
+{
+    // Either side of 14024.5 kHz, where rounding to a kHz would split them.
+    RbnAggregator aggregator;
+    aggregator.add(rbnSpot("OH6BG", 14024400, 12), "EU", 1000);
+    aggregator.add(rbnSpot("DK9IP", 14024600, 10), "EU", 1000);
+    aggregator.add(rbnSpot("W3LPL", 14025300, 8), "NA", 1000);
+    QCOMPARE(aggregator.size(), 1);
+
+    aggregator.add(rbnSpot("OH6BG", 14027000, 12), "EU", 1000);
+    QCOMPARE(aggregator.size(), 2);
+
+    const QVector<RbnAggregate> updates = aggregator.takeUpdates(31000);
+    QCOMPARE(updates.size(), 2);
+    for (const RbnAggregate &update : updates) {
+        QCOMPARE(update.skimmers, update.hz == 14027000 ? 1 : 3);
+    }
+}
+
+void RbnAggregatorTest::updatesOncePerWindow()
+{
+    RbnAggregator aggregator(60000, 1000, 5000, 2);
+    aggregator.add(rbnSpot("OH6BG", 14025000, 12), "EU", 0);
+    QVERIFY(aggregator.takeUpdates(250).isEmpty());
+    aggregator.add(rbnSpot("DK9IP", 14025100, 5), "EU", 1000);
+    QVERIFY(aggregator.takeUpdates(1250).isEmpty());
+
+    // Settled: the first update already carries both skimmers.
+    QVector<RbnAggregate> updates = aggregator.takeUpdates(5000);
+    QCOMPARE(updates.size(), 1);
+    QCOMPARE(updates.first().skimmers, 2);
+
+    // More skimmers inside the window are folded in silently.
+    for (int i = 0; i < 50; ++i) {
+        aggregator.add(rbnSpot(QString("SK%1").arg(i), 14025000, i), "EU", 6000 + i * 1000);
+        QVERIFY(aggregator.takeUpdates(6250 + i * 1000).isEmpty());
+    }
+
+    updates = aggregator.takeUpdates(65000);
+    QCOMPARE(updates.size(), 1);
+    QCOMPARE(updates.first().skimmers, 50);
+
+    // Nothing new since, nothing to report.
+    QVERIFY(aggregator.takeUpdates(130000).isEmpty());
+}
+
+void RbnAggregatorTest::waitsForLoneSkimmer()
+{
+    RbnAggregator aggregator(60000, 1000, 5000, 2);
+    aggregator.add(rbnSpot("OH6BG", 14025000, 12), "EU", 0);
+    QVERIFY(aggregator.takeUpdates(5000).isEmpty());
+    QVERIFY(aggregator.takeUpdates(29999).isEmpty());
+
+    const QVector<RbnAggregate> updates = aggregator.takeUpdates(30000);
+    QCOMPARE(updates.size(), 1);
+    QCOMPARE(updates.first().skimmers, 1);
+}
+
+void RbnAggregatorTest::expiresReports()
+{
+    RbnAggregator aggregator(60000);
+    aggregator.add(rbnSpot("OH6BG", 14025000, 12), "EU", 0);
+    aggregator.takeUpdates(0);
+    QCOMPARE(aggregator.size(), 1);
+    aggregator.takeUpdates(60001);
+    QCOMPARE(aggregator.size(), 0);
+}
+
+#include "rbnaggregator_test.moc"
@@ -0,0 +1,163 @@
+#include <QtTest/QtTest>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include "rbnreceiver.h"
+
+class RbnReceiverTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void parsesCwSpot();
+    void parsesDigitalSpot();
+    void parsesRttySpot();
+    void parsesMultiWordType();
+    void rejectsOtherLines_data();
+    void rejectsOtherLines();
+    void readsServer();
+    void benchmarkRegex();
+    void benchmarkTokenizer();
+};
+
+QObject *createRbnReceiverTest()
+{
+    return new RbnReceiverTest();
+}
+
+static QList<QByteArray> rbnLines()
+{
+    const QByteArray lines[] = {
+        "DX de OH6BG-#:    14025.0  OG3Z         CW    12 dB  25 WPM  CQ      1234Z",
+        "DX de DK9IP-#:     7012.3  UA9CUA       CW     8 dB  31 WPM  DX      1235Z",
+        "DX de K9IMM-#:    14074.0  N0ABC        FT8   -5 dB  CQ      1236Z",
+        "DX de W3LPL-#:    14080.1  JA1XYZ       RTTY  17 dB  45 BPS  CQ      1237Z",
+        "DX de VE7CC-#:    14100.0  4U1UN        CW    22 dB  22 WPM  NCDXF B 1238Z",
+    };
+    QList<QByteArray> result;
+    for (int i = 0; i < 2000; ++i) {
+        result.append(lines[i % 5]);
+    }
+    return result;
+}
+
+void RbnReceiverTest::parsesCwSpot()
+{
+    RbnSpot spot;
+    QVERIFY(RbnReceiver::parseLine(
+        "DX de OH6BG-#:    14025.0  og3z         CW    12 dB  25 WPM  CQ      1234Z", &spot));
+    QCOMPARE(spot.spotter, QString("OH6BG"));
+    QCOMPARE(spot.call, QString("OG3Z"));
+    QCOMPARE(spot.hz, qint64(14025000));
+    QCOMPARE(spot.mode, QString("CW"));
+    QCOMPARE(spot.snr, 12);
+    QCOMPARE(spot.speed, 25);
+    QCOMPARE(spot.type, QString("CQ"));
+    QCOMPARE(spot.time, QString("1234"));
+}
+
+void RbnReceiverTest::parsesDigitalSpot()
+{
+    RbnSpot spot;
+    QVERIFY(RbnReceiver::parseLine(
+        "DX de K9IMM-#:    14074.0  N0ABC        FT8   -5 dB  CQ      1236Z", &spot));
+    QCOMPARE(spot.mode, QString("FT8"));
+    QCOMPARE(spot.snr, -5);
+    QCOMPARE(spot.speed, 0);
+    QCOMPARE(spot.type, QString("CQ"));
+}
+
+void RbnReceiverTest::parsesRttySpot()
+{
+    RbnSpot spot;
+    QVERIFY(RbnReceiver::parseLine(
+        "DX de W3LPL-#:    14080.125 JA1XYZ      RTTY  17 dB  45 BPS  CQ      1237Z", &spot));
+    QCOMPARE(spot.hz, qint64(14080125));
+    QCOMPARE(spot.speed, 45);
+}
+
+void RbnReceiverTest::parsesMultiWordType()
+{
+    RbnSpot spot;
+    QVERIFY(RbnReceiver::parseLine(
+        "DX de VE7CC-#:    14100.0  4U1UN        CW    22 dB  22 WPM  NCDXF B 1238Z", &spot));
+    QCOMPARE(spot.type, QString("NCDXF B"));
+    QCOMPARE(spot.time, QString("1238"));
+}
+
+void RbnReceiverTest::rejectsOtherLines_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("banner") << QByteArray("Welcome to the Reverse Beacon Network");
+    QTest::newRow("prompt") << QByteArray("Please enter your call:");
+    QTest::newRow("no colon") << QByteArray("DX de OH6BG-# 14025.0 OG3Z CW 12 dB 25 WPM CQ 1234Z");
+    QTest::newRow("bad freq") << QByteArray("DX de OH6BG-#: 14O25.0 OG3Z CW 12 dB 25 WPM CQ 1234Z");
+    QTest::newRow("no dB") << QByteArray("DX de OH6BG-#: 14025.0 OG3Z CW 12 25 WPM CQ 1234Z");
+    QTest::newRow("no time") << QByteArray("DX de OH6BG-#: 14025.0 OG3Z CW 12 dB 25 WPM CQ");
+    QTest::newRow("truncated") << QByteArray("DX de OH6BG-#: 14025.0 OG3Z");
+}
+
+void RbnReceiverTest::rejectsOtherLines()
+{
+    QFETCH(QByteArray, line);
+    RbnSpot spot;
+    QVERIFY(!RbnReceiver::parseLine(line, &spot));
+}
+
+void RbnReceiverTest::readsServer()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QSettings settings(dir.filePath("rbn.ini"), QSettings::IniFormat);
+    RbnServer server = RbnReceiver::serverFromSettings(settings);
+    QCOMPARE(server.host, QString("telnet.reversebeacon.net"));
+    QCOMPARE(server.port, quint16(7000));
+    QCOMPARE(server.login, QString("OG3Z"));
+
+    settings.setValue("rbn/host", "rbn.example.org");
+    settings.setValue("rbn/port", 7001);
+    settings.setValue("rbn/login", "OH2XX");
+    server = RbnReceiver::serverFromSettings(settings);
+    QCOMPARE(server.host, QString("rbn.example.org"));
+    QCOMPARE(server.port, quint16(7001));
+    QCOMPARE(server.login, QString("OH2XX"));
+
+    // A blank value falls back to the built-in server.
+    settings.setValue("rbn/host", "");
+    QCOMPARE(RbnReceiver::serverFromSettings(settings).host, QString("telnet.reversebeacon.net"));
+}
+
+void RbnReceiverTest::benchmarkRegex()
+{
+    // The pattern the RBN client used before the tokenizer.
+    static const QRegularExpression rbnLineRegex(
+        R"(^DX de\s+\S+:\s+([0-9.]+)\s+([A-Za-z0-9/]+)\b(?:\s+([A-Za-z0-9/]+))?)");
+    const QList<QByteArray> lines = rbnLines();
+    int parsed = 0;
+    QBENCHMARK {
+        for (const QByteArray &line : lines) {
+            if (rbnLineRegex.match(QString::fromUtf8(line).trimmed()).hasMatch()) {
+                ++parsed;
+            }
+        }
+    }
+    QVERIFY(parsed > 0);
+}
+
+void RbnReceiverTest::benchmarkTokenizer()
+{
+    const QList<QByteArray> lines = rbnLines();
+    int parsed = 0;
+    RbnSpot spot;
+    QBENCHMARK {
+        for (const QByteArray &line : lines) {
+            if (RbnReceiver::parseLine(line, &spot)) {
+                ++parsed;
+            }
+        }
+    }
+    QVERIFY(parsed > 0);
+}
+
+#include "rbnreceiver_test.moc"
@@ -0,0 +1,107 @@
+#include <QtTest/QtTest>
+
+#include "spotdeduper.h"
+
+class SpotDeduperTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void suppressesRespots();
+    void separatesSignals();
+    void passesModeUpgrade();
+    void expiresAfterWindow();
+    void reportsOrigin();
+    void survivesGrowth();
+};
+
+QObject *createSpotDeduperTest()
+{
+    return new SpotDeduperTest();
+}
+
+static DxSpot dxSpot(const QString &call, const QString &freq, const QString &mode = "CW",
+                     const QString &message = QString())
+{
+    DxSpot spot;
+    spot.call = call;
+    spot.freq = freq;
+    spot.mode = mode;
+    spot.message = message;
+    return spot;
+}
+
+void SpotDeduperTest::suppressesRespots()
+{
+    SpotDeduper deduper;
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14025.0", "CW", "first"), 0));
+    QVERIFY(!deduper.offer(dxSpot("OG3Z", "14025.3", "CW", "second"), 1000));
+    QVERIFY(!deduper.offer(dxSpot("OG3Z", "14024.2", "CW", "third"), 2000));
+    QCOMPARE(deduper.suppressed(), quint64(2));
+    QCOMPARE(deduper.size(2000), 1);
+
+    const DxSpot *kept = deduper.find("OG3Z", 14025000, 2000);
+    QVERIFY(kept);
+    QCOMPARE(kept->message, QString("third"));
+}
+
+void SpotDeduperTest::separatesSignals()
+{
+    SpotDeduper deduper;
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14025.0"), 0));
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14030.0"), 0));
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "7025.0"), 0));
+    QVERIFY(deduper.offer(dxSpot("OH2BH", "14025.0"), 0));
+    QCOMPARE(deduper.size(0), 4);
+    QCOMPARE(deduper.suppressed(), quint64(0));
+}
+
+void SpotDeduperTest::passesModeUpgrade()
+{
+    SpotDeduper deduper;
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14200.0", "??"), 0));
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14200.0", "Ph"), 1000));
+    QVERIFY(!deduper.offer(dxSpot("OG3Z", "14200.0", "??"), 2000));
+    QCOMPARE(deduper.find("OG3Z", 14200000, 2000)->mode, QString("Ph"));
+}
+
+void SpotDeduperTest::expiresAfterWindow()
+{
+    SpotDeduper deduper(60000);
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14025.0"), 0));
+    QVERIFY(!deduper.offer(dxSpot("OG3Z", "14025.0"), 59999));
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14025.0"), 60000));
+    QCOMPARE(deduper.size(60000), 1);
+}
+
+void SpotDeduperTest::reportsOrigin()
+{
+    SpotDeduper deduper;
+    SpotDeduper::Origin origin;
+    QVERIFY(deduper.offer(dxSpot("OG3Z", "14025.0"), 1000, 1, &origin));
+    QCOMPARE(origin.source, 1);
+    QCOMPARE(origin.passedMs, qint64(1000));
+    QVERIFY(!deduper.offer(dxSpot("OG3Z", "14025.1"), 4000, 2, &origin));
+    QCOMPARE(origin.source, 1);
+    QCOMPARE(origin.passedMs, qint64(1000));
+}
+
+void SpotDeduperTest::survivesGrowth()
+{
+    SpotDeduper deduper(60000);
+    for (int i = 0; i < 5000; ++i) {
+        QVERIFY(deduper.offer(dxSpot(QString("OH%1A").arg(i), "14025.0"), i));
+    }
+    QCOMPARE(deduper.size(5000), 5000);
+    for (int i = 0; i < 5000; ++i) {
+        QVERIFY(!deduper.offer(dxSpot(QString("OH%1A").arg(i), "14025.5"), 5000 + i));
+    }
+    QCOMPARE(deduper.suppressed(), quint64(5000));
+
+    // Expired signals are swept instead of growing the table further.
+    for (int i = 0; i < 5000; ++i) {
+        QVERIFY(deduper.offer(dxSpot(QString("OH%1B").arg(i), "7025.0"), 200000 + i));
+    }
+    QCOMPARE(deduper.size(205000), 5000);
+}
+
+#include "spotdeduper_test.moc"
@@ -0,0 +1,125 @@
+#include <QtTest/QtTest>
+
+#include "spotmode.h"
+
+class SpotModeTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void classifiesComments_data();
+    void classifiesComments();
+    void fallsBackToFrequency();
+    void readsModeNames();
+    void benchmarkLegacyContains();
+    void benchmarkClassify();
+};
+
+QObject *createSpotModeTest()
+{
+    return new SpotModeTest();
+}
+
+void SpotModeTest::classifiesComments_data()
+{
+    QTest::addColumn<QString>("comment");
+    QTest::addColumn<QString>("mode");
+
+    QTest::newRow("ft8") << "FT8 -12dB from KP03" << "RT";
+    QTest::newRow("lower case") << "cq ft4" << "RT";
+    QTest::newRow("run together") << "CQFT8" << "RT";
+    QTest::newRow("overlapping") << "FFFT8" << "RT";
+    QTest::newRow("rtty") << "rtty contest" << "RT";
+    QTest::newRow("js8") << "js8call" << "RT";
+    QTest::newRow("psk") << "PSK31" << "RT";
+    QTest::newRow("msk144") << "MSK144 meteor scatter" << "RT";
+    QTest::newRow("cw") << "CW 25 dB 28 WPM" << "CW";
+    QTest::newRow("ssb") << "ssb up 5" << "Ph";
+    QTest::newRow("phone") << "PHONE" << "Ph";
+    QTest::newRow("sat beats cw") << "QO-100 SAT CW" << "SAT";
+    QTest::newRow("cw beats data") << "CW not RTTY" << "CW";
+    QTest::newRow("data beats phone") << "FT8 ssb later" << "RT";
+    QTest::newRow("no keyword") << "tnx qso 73" << "??";
+    QTest::newRow("empty") << "" << "??";
+    QTest::newRow("split by symbol") << "C-W" << "??";
+}
+
+void SpotModeTest::classifiesComments()
+{
+    QFETCH(QString, comment);
+    QFETCH(QString, mode);
+    QCOMPARE(spotModeName(spotModeFromComment(comment)), mode);
+}
+
+void SpotModeTest::fallsBackToFrequency()
+{
+    // Dial frequency plus audio offset.
+    QCOMPARE(spotModeFromFrequency(14074000), SpotMode::Data);
+    QCOMPARE(spotModeFromFrequency(14076500), SpotMode::Data);
+    QCOMPARE(spotModeFromFrequency(7047500), SpotMode::Data);
+    // Band-plan segments.
+    QCOMPARE(spotModeFromFrequency(14025000), SpotMode::Cw);
+    QCOMPARE(spotModeFromFrequency(14250000), SpotMode::Phone);
+    QCOMPARE(spotModeFromFrequency(50150000), SpotMode::Phone);
+    QCOMPARE(spotModeFromFrequency(13000000), SpotMode::Unknown);
+    QCOMPARE(spotModeFromFrequency(0), SpotMode::Unknown);
+
+    QCOMPARE(classifySpotMode(u"tnx", 14025000), SpotMode::Cw);
+    QCOMPARE(classifySpotMode(u"ssb", 14025000), SpotMode::Phone);
+}
+
+void SpotModeTest::readsModeNames()
+{
+    for (const SpotMode mode : {SpotMode::Cw, SpotMode::Data, SpotMode::Phone, SpotMode::Sat}) {
+        QCOMPARE(spotModeForName(spotModeName(mode)), mode);
+    }
+    QCOMPARE(spotModeForName(u"PH"), SpotMode::Phone);
+    QCOMPARE(spotModeForName(u"??"), SpotMode::Unknown);
+    QCOMPARE(spotModeForName(u""), SpotMode::Unknown);
+}
+
+static QStringList spotComments()
+{
+    const QStringList samples = {
+        "CW 25 dB 28 WPM CQ", "FT8 -12dB from KP03 1500Hz", "tnx qso 73",
+        "up 5 ssb", "via QO-100 sat", "rtty contest", "pse QSL direct", "CQ TEST"
+    };
+    QStringList comments;
+    for (int i = 0; i < 10000; ++i) {
+        comments.append(samples.at(i % samples.size()));
+    }
+    return comments;
+}
+
+void SpotModeTest::benchmarkLegacyContains()
+{
+    // The per-spot toUpper() and contains() chain this classifier replaced.
+    const QStringList comments = spotComments();
+    int classified = 0;
+    QBENCHMARK {
+        for (const QString &msg : comments) {
+            const QString msgUp = msg.toUpper();
+            if (msgUp.contains("SAT") || msgUp.contains("CW") || msgUp.contains("RTTY")
+                || msgUp.contains("FT8") || msgUp.contains("FT4") || msgUp.contains("DATA")
+                || msgUp.contains("SSB") || msgUp.contains("PHONE")) {
+                ++classified;
+            }
+        }
+    }
+    QVERIFY(classified > 0);
+}
+
+void SpotModeTest::benchmarkClassify()
+{
+    const QStringList comments = spotComments();
+    int classified = 0;
+    QBENCHMARK {
+        for (const QString &msg : comments) {
+            if (spotModeFromComment(msg) != SpotMode::Unknown) {
+                ++classified;
+            }
+        }
+    }
+    QVERIFY(classified > 0);
+}
+
+#include "spotmode_test.moc"
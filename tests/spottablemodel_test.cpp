@@ -0,0 +1,201 @@
+#include <QtTest/QtTest>
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+
+#include "spottablemodel.h"
+
+class SpotTableModelTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertsNewestFirst();
+    void evictsOldestWhenFull();
+    void expiresFromBottom();
+    void removesSelectedRows();
+    void filtersBySelection();
+    void masksOneBitPerGroup();
+    void addCostIsFlat_data();
+    void addCostIsFlat();
+    void refilterCost();
+};
+
+QObject *createSpotTableModelTest()
+{
+    return new SpotTableModelTest();
+}
+
+static DxSpot dxSpot(const QString &call, qint64 epoch, Band band = Band::M20,
+                     SpotMode mode = SpotMode::Cw, Continent continent = Continent::Eu)
+{
+    DxSpot spot;
+    spot.call = call;
+    spot.epoch = epoch;
+    spot.band = band;
+    spot.modeGroup = mode;
+    spot.continent = continent;
+    return spot;
+}
+
+static QStringList calls(const QAbstractItemModel &model)
+{
+    QStringList out;
+    for (int row = 0; row < model.rowCount(); ++row) {
+        out << model.index(row, SpotTableModel::CallColumn).data().toString();
+    }
+    return out;
+}
+
+void SpotTableModelTest::insertsNewestFirst()
+{
+    SpotTableModel model(10);
+    QAbstractItemModelTester tester(&model);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    model.addSpots({dxSpot("OG3Z", 1), dxSpot("OH2BH", 2)});
+    model.addSpots({dxSpot("K1ABC", 3)});
+    QCOMPARE(calls(model), QStringList({"K1ABC", "OH2BH", "OG3Z"}));
+    QCOMPARE(inserted.size(), 2);
+    QCOMPARE(inserted.at(1).at(1).toInt(), 0);
+    QCOMPARE(inserted.at(1).at(2).toInt(), 0);
+}
+
+void SpotTableModelTest::evictsOldestWhenFull()
+{
+    SpotTableModel model(3);
+    QAbstractItemModelTester tester(&model);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+    model.addSpots({dxSpot("A1", 1), dxSpot("A2", 2), dxSpot("A3", 3)});
+    model.addSpots({dxSpot("A4", 4), dxSpot("A5", 5)});
+    QCOMPARE(calls(model), QStringList({"A5", "A4", "A3"}));
+    QCOMPARE(removed.size(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 1);
+    QCOMPARE(removed.at(0).at(2).toInt(), 2);
+
+    // A batch larger than the buffer keeps only its newest spots.
+    model.addSpots({dxSpot("B1", 6), dxSpot("B2", 7), dxSpot("B3", 8), dxSpot("B4", 9)});
+    QCOMPARE(calls(model), QStringList({"B4", "B3", "B2"}));
+}
+
+void SpotTableModelTest::expiresFromBottom()
+{
+    SpotTableModel model(4);
+    QAbstractItemModelTester tester(&model);
+    model.addSpots({dxSpot("A1", 10), dxSpot("A2", 20), dxSpot("A3", 30)});
+    model.addSpots({dxSpot("A4", 40), dxSpot("A5", 50)});
+
+    QCOMPARE(model.expireBefore(35), 1);
+    QCOMPARE(calls(model), QStringList({"A5", "A4"}));
+    QCOMPARE(model.expireBefore(35), 0);
+    QCOMPARE(model.expireBefore(100), 2);
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void SpotTableModelTest::removesSelectedRows()
+{
+    SpotTableModel model(4);
+    QAbstractItemModelTester tester(&model);
+    // Wrapped around the end of the buffer.
+    model.addSpots({dxSpot("A1", 1), dxSpot("A2", 2), dxSpot("A3", 3)});
+    model.addSpots({dxSpot("A4", 4), dxSpot("A5", 5), dxSpot("A6", 6)});
+
+    model.removeSpotRows({3, 1, 1});
+    QCOMPARE(calls(model), QStringList({"A6", "A4"}));
+    model.addSpots({dxSpot("A7", 7)});
+    QCOMPARE(calls(model), QStringList({"A7", "A6", "A4"}));
+    QCOMPARE(model.expireBefore(5), 1);
+    QCOMPARE(calls(model), QStringList({"A7", "A6"}));
+}
+
+void SpotTableModelTest::filtersBySelection()
+{
+    SpotTableModel model(10);
+    SpotFilterModel filter(&model);
+    QAbstractItemModelTester tester(&filter);
+    model.addSpots({
+        dxSpot("CW20", 1, Band::M20, SpotMode::Cw, Continent::Eu),
+        dxSpot("PH40", 2, Band::M40, SpotMode::Phone, Continent::Na),
+        dxSpot("NOBAND", 3, Band::None, SpotMode::Cw, Continent::Eu),
+    });
+    QCOMPARE(filter.rowCount(), 3);
+
+    // Only 20 and 40 m, heard in Europe.
+    const quint32 bands = SpotFilter::bandBit(Band::M20) | SpotFilter::bandBit(Band::M40);
+    const quint32 continents = SpotFilter::continentBit(Continent::Eu);
+    filter.setRejected((SpotFilter::kBands & ~bands) | (SpotFilter::kContinents & ~continents));
+    QCOMPARE(calls(filter), QStringList({"CW20"}));
+
+    // New spots are tested as they arrive.
+    model.addSpots({dxSpot("CW40", 4, Band::M40, SpotMode::Cw, Continent::Eu)});
+    QCOMPARE(calls(filter), QStringList({"CW40", "CW20"}));
+
+    // Nothing checked in a group hides every spot.
+    filter.setRejected(SpotFilter::kModes);
+    QCOMPARE(filter.rowCount(), 0);
+    filter.setRejected(0);
+    QCOMPARE(filter.rowCount(), 4);
+}
+
+void SpotTableModelTest::masksOneBitPerGroup()
+{
+    const quint32 mask = SpotFilter::spotMask(dxSpot("OG3Z", 0, Band::M2, SpotMode::Sat, Continent::Sa));
+    QCOMPARE(mask & SpotFilter::kBands, SpotFilter::bandBit(Band::M2));
+    QCOMPARE(mask & SpotFilter::kModes, SpotFilter::modeBit(SpotMode::Sat));
+    QCOMPARE(mask & SpotFilter::kContinents, SpotFilter::continentBit(Continent::Sa));
+
+    const quint32 unknown = SpotFilter::spotMask(DxSpot());
+    QCOMPARE(unknown, SpotFilter::bandBit(Band::None) | SpotFilter::modeBit(SpotMode::Unknown)
+                          | SpotFilter::continentBit(Continent::None));
+    QVERIFY(!SpotFilter::accepts(unknown, SpotFilter::bandBit(Band::None)));
+    QVERIFY(SpotFilter::accepts(mask, SpotFilter::kBands & ~SpotFilter::bandBit(Band::M2)));
+}
+
+void SpotTableModelTest::addCostIsFlat_data()
+{
+    QTest::addColumn<int>("retained");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("50k") << 50000;
+}
+
+void SpotTableModelTest::addCostIsFlat()
+{
+    QFETCH(int, retained);
+
+    // A full buffer, so every add also evicts, behind the filter as in the UI.
+    SpotTableModel model(retained);
+    SpotFilterModel filter(&model);
+    QVector<DxSpot> backlog;
+    for (int i = 0; i < retained; ++i) {
+        backlog.append(dxSpot(QString("OG%1Z").arg(i), i));
+    }
+    model.addSpots(backlog);
+    QCOMPARE(filter.rowCount(), retained);
+
+    const QVector<DxSpot> one = {dxSpot("OH2BH", retained)};
+    QBENCHMARK {
+        model.addSpots(one);
+    }
+    QCOMPARE(model.rowCount(), retained);
+}
+
+void SpotTableModelTest::refilterCost()
+{
+    // A checkbox toggle with 50k spots retained: one AND per row.
+    SpotTableModel model;
+    SpotFilterModel filter(&model);
+    QVector<DxSpot> backlog;
+    for (int i = 0; i < model.capacity(); ++i) {
+        backlog.append(dxSpot(QString("OG%1Z").arg(i), i, i % 2 ? Band::M20 : Band::M40));
+    }
+    model.addSpots(backlog);
+
+    const quint32 no20 = SpotFilter::bandBit(Band::M20);
+    QBENCHMARK {
+        filter.setRejected(no20);
+        filter.setRejected(0);
+    }
+    filter.setRejected(no20);
+    QCOMPARE(filter.rowCount(), model.capacity() / 2);
+}
+
+#include "spottablemodel_test.moc"
@@ -0,0 +1,196 @@
+#include <QtTest/QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "spotwriter.h"
+
+class SpotWriterTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void flushesAtBatchSize();
+    void flushesOnTimer();
+    void flushesOnDestruction();
+    void keepsQueueOnFailure();
+    void numbersSpotsByRowid();
+    void writeThroughput_data();
+    void writeThroughput();
+};
+
+QObject *createSpotWriterTest()
+{
+    return new SpotWriterTest();
+}
+
+static QSqlDatabase openSpots(const QString &connection, const QString &path = ":memory:")
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+    db.setDatabaseName(path);
+    if (db.open()) {
+        QSqlQuery q(db);
+        q.exec(R"(CREATE TABLE spots (time TEXT, call TEXT, freq TEXT, mode TEXT, country TEXT,
+                  spotter TEXT, message TEXT, dxcc INTEGER, ts INTEGER, hz INTEGER,
+                  band INTEGER, mode_group INTEGER, continent INTEGER))");
+    }
+    return db;
+}
+
+static int spotCount(QSqlDatabase db)
+{
+    QSqlQuery q(db);
+    return q.exec("SELECT COUNT(*) FROM spots") && q.next() ? q.value(0).toInt() : -1;
+}
+
+static QVector<DxSpot> dxSpots(int count)
+{
+    QVector<DxSpot> spots;
+    for (int i = 0; i < count; ++i) {
+        DxSpot spot;
+        spot.call = QString("OG%1Z").arg(i);
+        spot.freq = "14025.0";
+        spot.epoch = i;
+        spot.hz = 14025000;
+        spot.band = Band::M20;
+        spots.append(spot);
+    }
+    return spots;
+}
+
+void SpotWriterTest::flushesAtBatchSize()
+{
+    const QString connection = "spotwriter_batch";
+    {
+        QSqlDatabase db = openSpots(connection);
+        QVERIFY(db.isOpen());
+        SpotWriter writer(db);
+        writer.setFlushInterval(60000);
+        writer.setMaxBatch(3);
+        QSignalSpy flushed(&writer, &SpotWriter::flushed);
+
+        writer.enqueue(dxSpots(2));
+        QCOMPARE(writer.queueDepth(), 2);
+        QCOMPARE(spotCount(db), 0);
+
+        writer.enqueue(dxSpots(1));
+        QCOMPARE(writer.queueDepth(), 0);
+        QCOMPARE(spotCount(db), 3);
+        QCOMPARE(flushed.size(), 1);
+        QCOMPARE(flushed.at(0).at(0).toInt(), 3);
+        QCOMPARE(writer.written(), quint64(3));
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+void SpotWriterTest::flushesOnTimer()
+{
+    const QString connection = "spotwriter_timer";
+    {
+        QSqlDatabase db = openSpots(connection);
+        SpotWriter writer(db);
+        writer.setFlushInterval(20);
+        writer.enqueue(dxSpots(5));
+        QCOMPARE(spotCount(db), 0);
+        QTRY_COMPARE(spotCount(db), 5);
+        QCOMPARE(writer.queueDepth(), 0);
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+void SpotWriterTest::flushesOnDestruction()
+{
+    const QString connection = "spotwriter_shutdown";
+    {
+        QSqlDatabase db = openSpots(connection);
+        {
+            SpotWriter writer(db);
+            writer.setFlushInterval(60000);
+            writer.enqueue(dxSpots(4));
+        }
+        QCOMPARE(spotCount(db), 4);
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+void SpotWriterTest::keepsQueueOnFailure()
+{
+    const QString connection = "spotwriter_failure";
+    {
+        QSqlDatabase db = openSpots(connection);
+        QSqlQuery q(db);
+        QVERIFY(q.exec("DROP TABLE spots"));
+
+        SpotWriter writer(db);
+        writer.setFlushInterval(60000);
+        writer.enqueue(dxSpots(2));
+        QVERIFY(!writer.flush());
+        QCOMPARE(writer.queueDepth(), 2);
+        QCOMPARE(writer.written(), quint64(0));
+        writer.enqueue(dxSpots(1));
+        QCOMPARE(writer.queueDepth(), 3);
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+void SpotWriterTest::numbersSpotsByRowid()
+{
+    const QString connection = "spotwriter_rowid";
+    {
+        QSqlDatabase db = openSpots(connection);
+        QSqlQuery q(db);
+        QVERIFY(q.exec("INSERT INTO spots (rowid, call) VALUES (41, 'OH2BH')"));
+
+        SpotWriter writer(db);
+        writer.setFlushInterval(60000);
+        const QVector<DxSpot> first = writer.enqueue(dxSpots(2));
+        const QVector<DxSpot> second = writer.enqueue(dxSpots(1));
+        QCOMPARE(first.at(0).id, qint64(42));
+        QCOMPARE(first.at(1).id, qint64(43));
+        QCOMPARE(second.at(0).id, qint64(44));
+        QVERIFY(writer.flush());
+
+        // Identical spots, each deletable on its own.
+        QVERIFY(q.exec("DELETE FROM spots WHERE rowid = 43"));
+        QVERIFY(q.exec("SELECT rowid, call FROM spots WHERE call = 'OG0Z' ORDER BY rowid"));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toLongLong(), qint64(42));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toLongLong(), qint64(44));
+        QVERIFY(!q.next());
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+void SpotWriterTest::writeThroughput_data()
+{
+    QTest::addColumn<int>("batch");
+    QTest::newRow("per spot") << 1;
+    QTest::newRow("batched") << SpotWriter::kDefaultMaxBatch;
+}
+
+void SpotWriterTest::writeThroughput()
+{
+    QFETCH(int, batch);
+
+    // On disk, where each commit pays for a sync.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString connection = "spotwriter_throughput";
+    {
+        QSqlDatabase db = openSpots(connection, dir.filePath("spots.sqlite"));
+        QVERIFY(db.isOpen());
+        SpotWriter writer(db);
+        writer.setFlushInterval(60000);
+        writer.setMaxBatch(batch);
+        const QVector<DxSpot> spots = dxSpots(SpotWriter::kDefaultMaxBatch);
+        QBENCHMARK {
+            for (const DxSpot &spot : spots) {
+                writer.enqueue({spot});
+            }
+            writer.flush();
+        }
+    }
+    QSqlDatabase::removeDatabase(connection);
+}
+
+#include "spotwriter_test.moc"
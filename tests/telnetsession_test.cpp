@@ -0,0 +1,157 @@
+#include <QtTest/QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "telnetsession.h"
+
+class TelnetSessionTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void backoffGrowsWithJitter();
+    void logsInAtThrottledPrompt();
+    void reconnectsAfterDrop();
+    void reconnectsAfterStall();
+    void boundsSendQueue();
+};
+
+QObject *createTelnetSessionTest()
+{
+    return new TelnetSessionTest();
+}
+
+static TelnetSession::Options localOptions(const QTcpServer &server)
+{
+    TelnetSession::Options options;
+    options.host = "127.0.0.1";
+    options.port = server.serverPort();
+    options.login = "OG3Z";
+    options.initialBackoffMs = 20;
+    options.maxBackoffMs = 200;
+    options.connectTimeoutMs = 2000;
+    return options;
+}
+
+// Non-blocking, so QTRY_VERIFY keeps the client's event loop turning.
+static QTcpSocket *nextClient(QTcpServer &server)
+{
+    return server.hasPendingConnections() ? server.nextPendingConnection() : nullptr;
+}
+
+void TelnetSessionTest::backoffGrowsWithJitter()
+{
+    QCOMPARE(TelnetSession::backoffMs(0, 1000, 120000, 0.0), 500);
+    QCOMPARE(TelnetSession::backoffMs(0, 1000, 120000, 1.0), 1000);
+    QCOMPARE(TelnetSession::backoffMs(3, 1000, 120000, 0.0), 4000);
+    QCOMPARE(TelnetSession::backoffMs(3, 1000, 120000, 1.0), 8000);
+    QCOMPARE(TelnetSession::backoffMs(40, 1000, 120000, 0.0), 60000);
+    QCOMPARE(TelnetSession::backoffMs(40, 1000, 120000, 1.0), 120000);
+}
+
+void TelnetSessionTest::logsInAtThrottledPrompt()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    TelnetSession::Options options = localOptions(server);
+    options.loginPrompt = "Please enter your call:";
+    TelnetSession session(options);
+    QList<QByteArray> lines;
+    connect(&session, &TelnetSession::lineReceived, this, [&lines](QByteArrayView line) {
+        lines.append(line.toByteArray());
+    });
+    session.start();
+
+    QTcpSocket *peer = nullptr;
+    QTRY_VERIFY((peer = nextClient(server)) != nullptr);
+    peer->write("Welcome\r\nPlease enter ");
+    peer->flush();
+    QTRY_COMPARE(lines.size(), 1);
+    QTest::qWait(50);
+    QCOMPARE(peer->bytesAvailable(), 0);
+
+    peer->write("your call: ");
+    QTRY_VERIFY(peer->canReadLine());
+    QCOMPARE(peer->readLine(), QByteArray("OG3Z\r\n"));
+
+    // A spot trickling in a few bytes at a time still arrives whole.
+    const QByteArray spot = "DX de OH6BG-#:    14025.0  OG3Z         CW    12 dB  25 WPM  CQ      1234Z";
+    for (int i = 0; i < spot.size(); i += 7) {
+        peer->write(spot.mid(i, 7));
+        peer->flush();
+        QTest::qWait(2);
+    }
+    peer->write("\r\n");
+    QTRY_COMPARE(lines.size(), 2);
+    QCOMPARE(lines.at(0), QByteArray("Welcome"));
+    QCOMPARE(lines.at(1), spot);
+    session.stop();
+}
+
+void TelnetSessionTest::reconnectsAfterDrop()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    TelnetSession session(localOptions(server));
+    int connects = 0;
+    int drops = 0;
+    connect(&session, &TelnetSession::connected, this, [&connects]() { ++connects; });
+    connect(&session, &TelnetSession::disconnected, this, [&drops]() { ++drops; });
+    session.start();
+
+    QTcpSocket *first = nullptr;
+    QTRY_VERIFY((first = nextClient(server)) != nullptr);
+    QTRY_VERIFY(first->canReadLine());
+    QCOMPARE(first->readLine(), QByteArray("OG3Z\r\n"));
+    first->close();
+
+    QTcpSocket *second = nullptr;
+    QTRY_VERIFY((second = nextClient(server)) != nullptr);
+    QTRY_COMPARE(connects, 2);
+    QCOMPARE(drops, 1);
+    session.stop();
+}
+
+void TelnetSessionTest::reconnectsAfterStall()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    TelnetSession::Options options = localOptions(server);
+    options.idleTimeoutMs = 200;
+    TelnetSession session(options);
+    int drops = 0;
+    connect(&session, &TelnetSession::disconnected, this, [&drops]() { ++drops; });
+    session.start();
+
+    // The peer accepts and then never says anything.
+    QTcpSocket *first = nullptr;
+    QTRY_VERIFY((first = nextClient(server)) != nullptr);
+    QTcpSocket *second = nullptr;
+    QTRY_VERIFY((second = nextClient(server)) != nullptr);
+    QCOMPARE(drops, 1);
+    session.stop();
+}
+
+void TelnetSessionTest::boundsSendQueue()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+    TelnetSession::Options options = localOptions(server);
+    options.maxQueuedBytes = 32;
+    TelnetSession session(options);
+
+    // Lines wait for the login; the queue refuses what does not fit.
+    QVERIFY(session.sendLine("SH/DX 10"));
+    QVERIFY(session.sendLine("SET/NOBEEP"));
+    QVERIFY(!session.sendLine("SET/WCY and then some more"));
+    QCOMPARE(session.queuedBytes(), qsizetype(22));
+
+    session.start();
+    QTcpSocket *peer = nullptr;
+    QTRY_VERIFY((peer = nextClient(server)) != nullptr);
+    QByteArray received;
+    QTRY_VERIFY((received += peer->readAll()).size() >= 6 + 22);
+    QCOMPARE(received, QByteArray("OG3Z\r\nSH/DX 10\r\nSET/NOBEEP\r\n"));
+    session.stop();
+}
+
+#include "telnetsession_test.moc"
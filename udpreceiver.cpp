@@ -1,4 +1,5 @@
 #include "udpreceiver.h"
+#include "bandplan.h"
 #include <QDataStream>
 #include <QTime>
 #include <QDebug>
@@ -138,21 +139,6 @@ static bool decodeType6(QDataStream &ds, const QString &id)
     return true;
 }
 
-static QString bandFromHz(quint64 hz)
-{
-    // Return strings matching your DB columns: "10","12","15","17","20","30","40","80"
-    // (rough band edges; adjust if you want strict digital subbands)
-    if (hz >= 28000000ULL && hz <= 29700000ULL) return "10";
-    if (hz >= 24890000ULL && hz <= 24990000ULL) return "12";
-    if (hz >= 21000000ULL && hz <= 21450000ULL) return "15";
-    if (hz >= 18068000ULL && hz <= 18168000ULL) return "17";
-    if (hz >= 14000000ULL && hz <= 14350000ULL) return "20";
-    if (hz >= 10100000ULL && hz <= 10150000ULL) return "30";
-    if (hz >=  7000000ULL && hz <=  7300000ULL) return "40";
-    if (hz >=  3500000ULL && hz <=  4000000ULL) return "80";
-    return ""; // unknown/not one of your columns
-}
-
 static bool decodeType5_QsoLoggedAndEmit(QDataStream &ds, UdpReceiver *self)
 {
     // Type 5 (QSO Logged): common fields
@@ -185,7 +171,7 @@ static bool decodeType5_QsoLoggedAndEmit(QDataStream &ds, UdpReceiver *self)
         return true; // decoded fine, but ignore other modes
     }
 
-    const QString band = bandFromHz(dialFreqHz);
+    const QString band = bandName(bandForHz(qint64(dialFreqHz)));
     if (band.isEmpty()) {
         // Not one of your DB columns; still can emit if you want.
         qDebug().noquote() << "QSO_LOGGED (ignored band) call=" << dxCall